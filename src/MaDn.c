@@ -1,18 +1,24 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
 
 #include "inputHandler.h"
+#include "gameRules.h"
+#include "evaluator.h"
+#include "history.h"
+#include "memTrack.h"
+#include "renderList.h"
+#include "winMeter.h"
+#include "strategy.h"
+#include "task.h"
 #include <psp2/ctrl.h>
 #include <psp2/kernel/processmgr.h>
 #include <vita2d.h>
 #include <vitasdk.h>
 
-#define WIDTH 960 // Screen width
-#define HEIGHT 544 // Screen height
-#define POFF 10 // Player number offset (Ex: POFF == 10, P1 = 10, P2 = 20)
-
 #define RED     RGBA8(255,   0,   0, 255)
 #define YELLOW  RGBA8(255, 255,   0, 255)
 #define BLUE    RGBA8(  0,   0, 255, 255)
@@ -24,769 +30,604 @@
 #define PINK    RGBA8(255, 192, 203, 255)
 #define ALMOND	RGBA8(209, 182, 137, 255)
 
-typedef enum tEnumPlayer{
-    NoPosition,
-	Empty,
-	PlayerOne = 1*POFF,
-    PlayerOneHome,
-    PlayerOneStart,
-	PlayerTwo = 2*POFF,
-	PlayerTwoHome,
-    PlayerTwoStart,
-    PlayerThree = 3*POFF,
-    PlayerThreeHome,
-    PlayerThreeStart,
-    PlayerFour = 4*POFF,
-    PlayerFourHome,
-    PlayerFourStart
-} tEnumPlayer;
-
-typedef struct tStBoard
+#define HINT_BUDGET_US 1000 // Time per frame spent on move hints while the player is waiting
+#define WINMETER_BUDGET_US 2000 // Time per frame spent on win chance playouts while the meter is shown
+#define DEBUG_X 760 // Debug overlay in the right margin
+#define DEBUG_Y 30
+#define DEBUG_LINE 22
+#define DEBUG_SCALE 0.8f
+
+// Colors per player (tEnumPlayer/POFF) and kind of field (tEnumPlayer%POFF: pawn, home, start)
+static const unsigned int aauiPalette[5][3] = {
+    {BLACK,  WHITE,                          WHITE},
+    {RED,    RGBA8(255/2,     0,     0, 255), RED},
+    {YELLOW, RGBA8(255/2, 255/2,     0, 255), YELLOW},
+    {BLUE,   RGBA8(    0,     0, 255/2, 255), BLUE},
+    {GREEN,  RGBA8(    0, 255/2,     0, 255), GREEN}
+};
+
+typedef struct tStHints
 {
-	unsigned short uiX;
-	unsigned short uiY;
-	tEnumPlayer eData;
-} tStBoard;
-
-typedef struct tStGame
+    tStPosition astBest[7]; // Recommended pawn for every dice value
+    tStPosition aastLegal[7][4]; // Pawns which are able to move for every dice value
+    unsigned short auiNrOfLegal[7];
+    unsigned short uiStep; // Next step of ComputeHintStep
+    bool xReady; // Hints for all dice values are computed
+    unsigned long long ulStartTime;
+    unsigned long long ulFirstHintUs; // Time from the start of waiting until the hints were ready
+    unsigned int uiHits; // Dice landed on an already precomputed hint
+    unsigned int uiMisses;
+} tStHints;
+
+typedef struct tStFlowStats
 {
-	tStBoard **Field;
-	tEnumPlayer eTurn;
-	unsigned short uiCellWidth;
-	unsigned short uiCellHeight;
-	unsigned short uiFieldWidth;
-	unsigned short uiFieldHeight;
-} tStGame;
-
-typedef struct tStPosition
+    unsigned int uiFrame;
+    unsigned int uiRollFrame; // Frame of the last throw, moved on by the frames the player took to pick a pawn
+    unsigned int uiPickFrame; // Frame the player was asked to pick a pawn
+    unsigned int uiMoves;
+    unsigned int uiLatencyFrames; // Frames from throwing the dice until the pawn starts moving, summed over all moves
+    unsigned int uiMaxLatencyFrames;
+} tStFlowStats;
+
+typedef struct tStTurnFlow
 {
-    unsigned short uiRowIndex;
-    unsigned short uiColIndex;
-    unsigned short uiMovesLeft;
-} tStPosition;
-
-typedef enum tEnumGameState
+    tStTask stTask;
+    tStTask stHintTask;
+    tStGame *stGame;
+    stGamePad *stMcd;
+    tStHints *stHints;
+    tStHistory *stHistory;
+    tStWinMeter *stMeter;
+    unsigned short uiDice;
+    unsigned short uiI; // Cursor
+    unsigned short uiJ;
+    unsigned short uiNrOfMaxPips;
+    tStPosition stOldPos; // Pawn which moves
+    tStPosition stPos; // Field the animated pawn lands on, -1 while nothing moves
+    bool xAwaitingThrow; // Player one may throw, take back or redo turns
+    bool xPicking; // Player one has to pick a pawn
+    bool xAniInit;
+    bool xAniDone;
+    tStFlowStats stStats;
+} tStTurnFlow;
+
+void ResetHints(tStHints *stHints)
 {
-    Waiting,
-    ThrowingDice,
-    ThrewHighestPips,
-    SummoningPawn,
-    PickingPawn,
-    MovingPawn,
-    AnimatingPawn,
-    EndingTurn
-} tEnumGameState;
-
-void BoardConstructor(tStGame *stGame)
+    stHints->uiStep = 0;
+    stHints->xReady = false;
+    stHints->ulStartTime = 0;
+}
+
+// The hints follow the strategy of the seat of player one. Step 0 scores all dice values in one batch,
+// step d collects the pawns which can move with dice value d.
+void ComputeHintStep(tStGame *stGame, tStHints *stHints)
 {
-	stGame->uiCellHeight = HEIGHT / stGame->uiFieldHeight;
-	stGame->uiCellWidth = stGame->uiCellHeight;
+    unsigned short uiDice = stHints->uiStep++;
+    bool xBestLegal = false;
 
-    unsigned short uiIncreaseRow = 0;
-	stGame->Field = malloc(sizeof(tStBoard *)*stGame->uiFieldHeight);
+    if (uiDice == 0){
+        StrategyPickAll(stGame, stHints->astBest);
+        return;
+    }
 
+    stHints->auiNrOfLegal[uiDice] = 0;
     for (int i=0; i<stGame->uiFieldHeight; i++){
-        uiIncreaseRow += i == 0 ? stGame->uiCellHeight/2 : stGame->uiCellHeight;
-        stGame->Field[i] = malloc(sizeof(tStBoard)*stGame->uiFieldWidth);
         for (int j=0; j<stGame->uiFieldWidth; j++){
-            stGame->Field[i][j].eData = NoPosition;
-            stGame->Field[i][j].uiY = uiIncreaseRow;
-            stGame->Field[i][j].uiX = j == 0 ? (WIDTH-(stGame->uiCellWidth*stGame->uiFieldWidth))/2 : stGame->Field[i][j-1].uiX + stGame->uiCellWidth;
+            tStPosition stPawn = ChoosePawn(stGame, i, j);
+            if (stPawn.uiColIndex <= stGame->uiFieldWidth && IsMoveLegal(stGame, stPawn, uiDice)){
+                stHints->aastLegal[uiDice][stHints->auiNrOfLegal[uiDice]] = stPawn;
+                stHints->auiNrOfLegal[uiDice]++;
+                xBestLegal |= (i == stHints->astBest[uiDice].uiRowIndex && j == stHints->astBest[uiDice].uiColIndex);
+            }
         }
     }
+
+    if (!xBestLegal){ // The greedy pick may choose a pawn which cannot enter the home pos
+        stHints->astBest[uiDice].uiRowIndex = stHints->auiNrOfLegal[uiDice] > 0 ? stHints->aastLegal[uiDice][0].uiRowIndex : -1;
+        stHints->astBest[uiDice].uiColIndex = stHints->auiNrOfLegal[uiDice] > 0 ? stHints->aastLegal[uiDice][0].uiColIndex : -1;
+    }
+    stHints->xReady = uiDice == 6;
 }
 
-void BoardDestructor(tStGame *stGame)
+void ComputeHints(tStGame *stGame, tStHints *stHints)
 {
-    for (int i=0; i<stGame->uiFieldHeight; i++){
-        free(stGame->Field[i]);
+    while (!stHints->xReady){
+        ComputeHintStep(stGame, stHints);
     }
-    free(stGame->Field);
 }
 
-void CreatePlayers(tStGame *stGame)
+// Runs steps until the budget of this frame is used up, the remaining steps follow in the next frames
+void UpdateHints(tStGame *stGame, tStHints *stHints)
 {
-    for (int i=0; i<stGame->uiFieldHeight; i++){
-        for (int j=0; j<stGame->uiFieldWidth; j++){
-            if (i%(stGame->uiFieldHeight-2) < 2 && j%(stGame->uiFieldWidth-2) < 2){
-                if (i < 2 && j < 2){
-                   stGame->Field[i][j].eData = PlayerOne;
-                } else if (i > 8 && j < 2){
-                    stGame->Field[i][j].eData = PlayerTwo;
-                } else if (i < 2 && j > 8){
-                    stGame->Field[i][j].eData = PlayerThree;
-                } else if (i > 8 && j > 8){
-                    stGame->Field[i][j].eData = PlayerFour;
-                }
-            }
+    unsigned long long ulNow = sceKernelGetProcessTimeWide();
+
+    if (stHints->ulStartTime == 0){
+        stHints->ulStartTime = ulNow;
+    }
+
+    while (!stHints->xReady && sceKernelGetProcessTimeWide() - ulNow < HINT_BUDGET_US){
+        ComputeHintStep(stGame, stHints);
+        if (stHints->xReady){
+            stHints->ulFirstHintUs = sceKernelGetProcessTimeWide() - stHints->ulStartTime;
         }
     }
 }
 
-void CreatePlayingCircle(tStGame *stGame)
+void GetHint(tStGame *stGame, tStHints *stHints)
 {
-    for (int i=0; i<stGame->uiFieldHeight; i++){
-        for (int j=0; j<stGame->uiFieldWidth; j++){
-            if ((i>3 && i<7) || (j>3 && j<7)){  
-                stGame->Field[i][j].eData = Empty;
-            }
-        }
+    if (stHints->xReady){
+        stHints->uiHits++;
+    } else{
+        stHints->uiMisses++;
+        ComputeHints(stGame, stHints);
     }
 }
 
-void CreateHomePositions(tStGame *stGame)
+unsigned int GetColor(tEnumPlayer eData)
 {
-    unsigned short uiI = stGame->uiFieldWidth / 2;
-    unsigned short uiJ = stGame->uiFieldHeight / 2;
-    stGame->Field[uiI][uiJ].eData = NoPosition;
-
-    for (int i=0; i<4; i++){ // Amount of players
-        for (int j=1; j<5; j++){ // Amount of home positions
-            if (i == 0){
-                stGame->Field[uiI][uiJ-j].eData = PlayerOneHome;
-            } else if (i == 1){
-                stGame->Field[uiI+j][uiJ].eData = PlayerTwoHome;
-            } else if (i == 2){
-                stGame->Field[uiI-j][uiJ].eData = PlayerThreeHome;
-            } else if (i == 3){
-                stGame->Field[uiI][uiJ+j].eData = PlayerFourHome;
-            }
-        }
-    }  
+    return aauiPalette[eData/POFF][eData%POFF];
 }
 
-void CreateStartPositions(tStGame *stGame)
+bool IsHintLegal(tStHints *stHints, unsigned short uiDice, unsigned short i, unsigned short j)
 {
-    stGame->Field[stGame->uiFieldHeight/2-1][0].eData = PlayerOneStart;
-    stGame->Field[stGame->uiFieldHeight-1][stGame->uiFieldWidth/2-1].eData = PlayerTwoStart;
-    stGame->Field[0][stGame->uiFieldWidth/2+1].eData = PlayerThreeStart;
-    stGame->Field[stGame->uiFieldHeight/2+1][stGame->uiFieldWidth-1].eData = PlayerFourStart;
+    for (int k=0; k<stHints->auiNrOfLegal[uiDice]; k++){
+        if (stHints->aastLegal[uiDice][k].uiRowIndex == i && stHints->aastLegal[uiDice][k].uiColIndex == j){
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void BoardInitializer(tStGame *stGame)
+static bool IsConfirmed(const stGamePad *stMcd)
 {
-    CreatePlayers(stGame);
-    CreatePlayingCircle(stGame);
-    CreateHomePositions(stGame);
-    // CreateStartPositions(stGame);
+    return stMcd->stButt[1].xTrigger || stMcd->stTouch[0].xTrigger;
 }
 
-unsigned short RollDice()
+static bool IsAnyTrigger(const stGamePad *stMcd)
 {
-    return (rand() % 6) + 1;
+    bool xTrigger = stMcd->stDpad[0].xTrigger || stMcd->stTouch[0].xTrigger;
+
+    for (int k=0; k<BUTTONS; k++){
+        xTrigger |= stMcd->stButt[k].xTrigger;
+    }
+    return xTrigger;
 }
 
-tStPosition ChoosePawn(tStGame *stGame, unsigned short i, unsigned short j)
+// Player one takes back or redoes whole turns with the L and R triggers until the dice is thrown
+static bool AwaitThrow(tStTurnFlow *pstFlow)
 {
-    tStPosition stPos = {-1, -1, 0};
-
-    if (stGame->Field[i][j].eData == stGame->eTurn){ // Did user selected his own pawn ?
-        if ((i>3 && i<7) || (j>3 && j<7)){ // Is the pawn on the field ?
-            if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2 ){ // Is the pawn not in the home position ?
-                stPos.uiRowIndex = i; stPos.uiColIndex = j;
-            } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){
-                stPos.uiRowIndex = i; stPos.uiColIndex = j;
-            }
+    if (pstFlow->stGame->eTurn != PlayerOne){
+        return true;
+    }
+
+    if (pstFlow->uiNrOfMaxPips == 0){
+        if ((pstFlow->stMcd->stButt[4].xTrigger && HistoryUndo(pstFlow->stHistory, pstFlow->stGame)) || (pstFlow->stMcd->stButt[5].xTrigger && HistoryRedo(pstFlow->stHistory, pstFlow->stGame))){
+            ResetHints(pstFlow->stHints);
+            WinMeterRestart(pstFlow->stMeter, pstFlow->stGame, sceKernelGetProcessTimeWide);
         }
     }
 
-    return stPos;
+    return IsConfirmed(pstFlow->stMcd);
 }
 
-tStPosition MovePawn(tStGame *stGame, unsigned short i, unsigned short j, unsigned short uiMoves)
+// Takes the pawn under the cursor when player one confirms, flashes red when it cannot move
+static bool AwaitPick(tStTurnFlow *pstFlow)
 {
-    //             CLOCKWISE                              ANTI CLOCKWISE
-	// j0 j1 j2 j3 j4 j5 j6 j7 j8 j9 j10        j0 j1 j2 j3 j4 j5 j6 j7 j8 j9 j10
-	// [1][1][ ][ ][→][→][↓][ ][ ][3][3] i0     [1][1][ ][ ][↓][←][←][ ][ ][3][3] i0
-	// [1][1][ ][ ][↑][|][↓][ ][ ][3][3] i1     [1][1][ ][ ][↓][|][↑][ ][ ][3][3] i1
-	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i2     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i2
-	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i3     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i3
-	// [→][→][→][→][↑][|][→][→][→][→][↓] i4     [↓][←][←][←][←][|][↑][←][←][←][←] i4
-	// [↑][—][—][—][—][⚄][—][—][—][—][↓] i5     [↓][—][—][—][—][⚄][—][—][—][—][↑] i5
-	// [↑][←][←][←][←][|][↓][←][←][←][←] i6     [→][→][→][→][→][|][→][→][→][→][↑] i6
-	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i7     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i7
-	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i8     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i8
-	// [2][2][ ][ ][↑][|][↓][ ][ ][4][4] i9     [2][2][ ][ ][↓][|][↑][ ][ ][4][4] i9
-	// [2][2][ ][ ][↑][←][←][ ][ ][4][4] i10    [2][2][ ][ ][→][→][↑][ ][ ][4][4] i10
-
-    bool xHomePos = false;
-    bool xPawnOnEdge = true;
-
-    if (stGame->eTurn == PlayerOne && i == stGame->uiFieldHeight/2 && j == 0){
-        xHomePos = true;
-    } else if (stGame->eTurn == PlayerTwo && i == stGame->uiFieldHeight-1 && j == stGame->uiFieldWidth/2){
-        xHomePos = true;
-    } else if (stGame->eTurn == PlayerThree && i == 0 && j == stGame->uiFieldWidth/2){
-        xHomePos = true;
-    } else if (stGame->eTurn == PlayerFour && i == stGame->uiFieldHeight/2 && j == stGame->uiFieldWidth-1){
-        xHomePos = true;
-    }
-    
-    if (uiMoves == 0 || xHomePos){
-        tStPosition stPos = {i, j, uiMoves};
-        return stPos;
+    if (!IsConfirmed(pstFlow->stMcd)){
+        return false;
     }
 
-    if (i == stGame->uiFieldHeight/2-1 && j != stGame->uiFieldWidth/2-1 && j != stGame->uiFieldWidth-1){
-        xPawnOnEdge = false;
-        j++;
-    } else if (i == stGame->uiFieldHeight/2+1 && j != stGame->uiFieldWidth/2+1 && j != 0){
-        xPawnOnEdge = false;
-        j--;
-    } else if (j == stGame->uiFieldWidth/2-1 && i != stGame->uiFieldHeight/2+1 && i != 0){
-        xPawnOnEdge = false;
-        i--;
-    } else if (j == stGame->uiFieldWidth/2+1 && i != stGame->uiFieldHeight/2-1 && i != stGame->uiFieldHeight-1){
-        xPawnOnEdge = false;
-        i++;
+    pstFlow->stOldPos = ChoosePawn(pstFlow->stGame, pstFlow->uiI, pstFlow->uiJ);
+    if (pstFlow->stOldPos.uiColIndex > pstFlow->stGame->uiFieldWidth || !IsMoveLegal(pstFlow->stGame, pstFlow->stOldPos, pstFlow->uiDice)){
+        vita2d_draw_rectangle(0, 0, WIDTH, HEIGHT, RED);
+        return false;
     }
-
-    if (xPawnOnEdge){
-        if (i == 0){
-            j++;
-        } else if (i == stGame->uiFieldHeight-1){
-            j--;
-        } else if (j == 0){
-            i--;
-        } else if (j == stGame->uiFieldWidth-1){
-            i++;
-        }
-    }
-
-    uiMoves--;
-    return MovePawn(stGame, i, j, uiMoves);
+    return true;
 }
 
-tStPosition CheckStartPos(tStGame *stGame, tEnumPlayer ePlayer, bool xFindEmptySpot)
+static void StartAnimation(tStTurnFlow *pstFlow)
 {
-    tStPosition stPos = {-1, -1, 0};
-
-    if (ePlayer == PlayerOne){
-        for (int i=0; i<2; i++){
-            for (int j=0; j<2; j++){
-                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerOne){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                }
-            }
-        }
-    } else if (ePlayer == PlayerTwo){
-        for (int i=stGame->uiFieldHeight-2; i<stGame->uiFieldHeight; i++){
-            for (int j=0; j<2; j++){
-                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerTwo){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                }
-            }
-        }
-    } else if (ePlayer == PlayerThree){
-        for (int i=0; i<2; i++){
-            for (int j=stGame->uiFieldWidth-2; j<stGame->uiFieldWidth; j++){
-                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerThree){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                }
-            }
-        }
-    }else if (ePlayer == PlayerFour){
-        for (int i=stGame->uiFieldHeight-2; i<stGame->uiFieldHeight; i++){
-            for (int j=stGame->uiFieldWidth-2; j<stGame->uiFieldWidth; j++){
-                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerFour){
-                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
-                }
-            }
-        }
-    }
+    unsigned int uiLatency = pstFlow->stStats.uiFrame - pstFlow->stStats.uiRollFrame;
+
+    pstFlow->stStats.uiMoves++;
+    pstFlow->stStats.uiLatencyFrames += uiLatency;
+    pstFlow->stStats.uiMaxLatencyFrames = max(uiLatency, pstFlow->stStats.uiMaxLatencyFrames);
 
-    return stPos;
+    pstFlow->uiNrOfMaxPips++;
+    pstFlow->xAniInit = true;
+    pstFlow->xAniDone = false;
+    ResetHints(pstFlow->stHints);
 }
 
-void RemovePlayer(tStGame *stGame, tStPosition stNewPos)
+static void StartSummon(tStTurnFlow *pstFlow)
 {
-    tStPosition stPos = CheckStartPos(stGame, stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData, true);
-    stGame->Field[stPos.uiRowIndex][stPos.uiColIndex].eData = stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData;
+    tStGame *stGame = pstFlow->stGame;
+
+    pstFlow->stOldPos = CheckStartPos(stGame, stGame->eTurn, false);
+    pstFlow->stPos = CheckHit(stGame, SummonPawn(stGame), pstFlow->stOldPos);
+    StartAnimation(pstFlow);
 }
 
-tStPosition CheckHit(tStGame *stGame, tStPosition stNewPos, tStPosition stOldPos)
+// Moves the pawn in stOldPos, returns false when no pawn was picked
+static bool StartMove(tStTurnFlow *pstFlow)
 {
-    tStPosition stPos = stNewPos;
+    tStGame *stGame = pstFlow->stGame;
+    tStPosition stOldPos = pstFlow->stOldPos;
 
-    if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData % POFF == 0){ // Modulus of POFF means it hit one of the four players
-        RemovePlayer(stGame, stNewPos); // Place the hitted player back in the starting pos
+    if (stOldPos.uiColIndex > stGame->uiFieldWidth){
+        return false;
     }
 
-    // stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData = stGame->eTurn; // Set current player to the new pos
-    stGame->Field[stOldPos.uiRowIndex][stOldPos.uiColIndex].eData = Empty; // Remove old traces of the current player
+    tStPosition stNewPos = MovePawn(stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, pstFlow->uiDice);
+    if (stNewPos.uiMovesLeft == 0){
+        pstFlow->stPos = CheckHit(stGame, stNewPos, stOldPos);
+    } else{
+        pstFlow->stPos = SetPlayerInHome(stGame, stNewPos);
+        if (pstFlow->stPos.uiMovesLeft == 0){
+            stGame->Field[stOldPos.uiRowIndex][stOldPos.uiColIndex].eData = Empty; // Remove old traces of the current player
+        } else{
+            pstFlow->stPos = stOldPos; // Move is impossible do not move player
+        }
+    }
 
-    return stPos;
+    StartAnimation(pstFlow);
+    return true;
 }
 
-void SwitchPlayer(tStGame *stGame)
+static void RestartGame(tStTurnFlow *pstFlow)
 {
-    stGame->eTurn+= POFF;
+    SceDateTime Time;
 
-    if (stGame->eTurn > PlayerFour){
-        stGame->eTurn = POFF;
+    BoardInitializer(pstFlow->stGame); // Reuse the board instead of allocating a new one
+    sceRtcGetCurrentClockLocalTime(&Time);
+    SeedDice(pstFlow->stGame, sceRtcGetMicrosecond(&Time));
+    ResetHints(pstFlow->stHints);
+    HistoryReset(pstFlow->stHistory);
+    WinMeterRestart(pstFlow->stMeter, pstFlow->stGame, sceKernelGetProcessTimeWide);
+    if (pstFlow->stGame->eTurn == PlayerOne){
+        HistoryPush(pstFlow->stHistory, pstFlow->stGame);
     }
 }
 
-tStPosition SummonPawn(tStGame *stGame)
+// One turn after the other, every throw waits for the input, the pick and the animation it needs
+static void PlayTurns(tStTask *pstTask)
 {
-    tStPosition stPos = {-1, -1, 0};
-
-    if (stGame->eTurn == PlayerOne){
-        stPos.uiRowIndex = stGame->uiFieldHeight/2-1;
-        stPos.uiColIndex = 0;
-    } else if (stGame->eTurn == PlayerTwo){
-        stPos.uiRowIndex = stGame->uiFieldHeight-1;
-        stPos.uiColIndex = stGame->uiFieldWidth/2-1;
-    } else if (stGame->eTurn == PlayerThree){
-        stPos.uiRowIndex = 0;
-        stPos.uiColIndex = stGame->uiFieldWidth/2+1;
-    } else if (stGame->eTurn == PlayerFour){
-        stPos.uiRowIndex = stGame->uiFieldHeight/2+1;
-        stPos.uiColIndex = stGame->uiFieldWidth-1;
-    }
-
-    return stPos;
-}
+    tStTurnFlow *pstFlow = pstTask->pvCtx;
+    tStGame *stGame = pstFlow->stGame;
+    tStPosition stNewPos;
+
+    TASK_BEGIN(pstTask);
+    while (true){
+        pstFlow->uiNrOfMaxPips = 0;
+
+        do{
+            pstFlow->uiDice = 0;
+            pstFlow->xAwaitingThrow = stGame->eTurn == PlayerOne;
+            TASK_WAIT_UNTIL(pstTask, TaskInput, AwaitThrow(pstFlow));
+            pstFlow->xAwaitingThrow = false;
+
+            pstFlow->uiDice = RollDice(stGame);
+            pstFlow->stStats.uiRollFrame = pstFlow->stStats.uiFrame;
+            if (stGame->eTurn == PlayerOne){
+                GetHint(stGame, pstFlow->stHints);
+            }
+            stNewPos = SummonPawn(stGame); // Was there already an pawn summoned ?
+
+            if (pstFlow->uiDice == 6 && pstFlow->uiNrOfMaxPips%2 == 0 && CheckStartPos(stGame, stGame->eTurn, false).uiColIndex <= stGame->uiFieldWidth){
+                StartSummon(pstFlow);
+            } else if (pstFlow->uiNrOfMaxPips%2 == 1 && stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData == stGame->eTurn){ // Force player to move the summoned pawn
+                pstFlow->stOldPos = stNewPos;
+                pstFlow->uiI = stNewPos.uiRowIndex;
+                pstFlow->uiJ = stNewPos.uiColIndex;
+                StartMove(pstFlow);
+            } else if (GetNumberOfSummonedPawns(stGame) == 0){ // Nothing can move, the turn ends even after a 6
+                break;
+            } else if (stGame->eTurn == PlayerOne && pstFlow->stHints->auiNrOfLegal[pstFlow->uiDice] == 0){ // No pawn can move, a 6 still throws again like it does for the computer
+                pstFlow->uiNrOfMaxPips++;
+                continue;
+            } else if (stGame->eTurn == PlayerOne){
+                pstFlow->xPicking = true;
+                pstFlow->stStats.uiPickFrame = pstFlow->stStats.uiFrame;
+                TASK_WAIT_UNTIL(pstTask, TaskInput, AwaitPick(pstFlow));
+                pstFlow->xPicking = false;
+                pstFlow->stStats.uiRollFrame += pstFlow->stStats.uiFrame - pstFlow->stStats.uiPickFrame; // Do not count the time the player thinks
+                StartMove(pstFlow);
+            } else{
+                pstFlow->stOldPos = PickPawnStrategy(stGame, pstFlow->uiDice);
+                if (!StartMove(pstFlow)){
+                    break;
+                }
+                pstFlow->uiI = pstFlow->stOldPos.uiRowIndex;
+                pstFlow->uiJ = pstFlow->stOldPos.uiColIndex;
+            }
 
-unsigned short GetNumberOfSummonedPawns(tStGame *stGame)
-{
-    unsigned short uiCount = 0;
+            TASK_WAIT_UNTIL(pstTask, TaskAnimation, pstFlow->xAniDone);
+            pstFlow->stPos.uiColIndex = -1;
+            pstFlow->stPos.uiRowIndex = -1;
+            WinMeterRestart(pstFlow->stMeter, stGame, sceKernelGetProcessTimeWide);
+        } while (pstFlow->uiDice == 6 && !CheckWinner(stGame));
 
-    for (int i=0; i<stGame->uiFieldHeight; i++){
-        for (int j=0; j<stGame->uiFieldWidth; j++){
-            if (((i>3 && i<7) || (j>3 && j<7)) && stGame->Field[i][j].eData == stGame->eTurn){
-                if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2){ // Exclude (home positions) out of check
-                    uiCount++;
-                } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){ // The edges of the excluded area hold valid pawn locations
-                    uiCount++;
-                }
+        if (CheckWinner(stGame)){
+            TASK_WAIT_UNTIL(pstTask, TaskInput, pstFlow->stMcd->stButt[2].xTrigger);
+            RestartGame(pstFlow);
+        } else{
+            SwitchPlayer(stGame);
+            WinMeterRestart(pstFlow->stMeter, stGame, sceKernelGetProcessTimeWide);
+            if (stGame->eTurn == PlayerOne){
+                HistoryPush(pstFlow->stHistory, stGame);
             }
         }
     }
-
-    return uiCount;
+    TASK_END(pstTask);
 }
 
-tStPosition SetPlayerInHome(tStGame *stGame, tStPosition stNewPos)
+// Precomputes the move hints in the frames player one takes to throw
+static void PrecomputeHints(tStTask *pstTask)
 {
-    tStPosition stPos = stNewPos;
-    unsigned short uiMoves = stNewPos.uiMovesLeft > 4 ? stNewPos.uiMovesLeft - (stNewPos.uiMovesLeft%4)*2 : stNewPos.uiMovesLeft;
+    tStTurnFlow *pstFlow = pstTask->pvCtx;
 
-    if (stGame->eTurn == PlayerOne){
-        if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex+uiMoves].eData == PlayerOneHome){
-            stPos.uiColIndex = stNewPos.uiColIndex+uiMoves; stPos.uiMovesLeft = 0;
-        }
-    } else if (stGame->eTurn == PlayerTwo){
-        if (stGame->Field[stNewPos.uiRowIndex-uiMoves][stNewPos.uiColIndex].eData == PlayerTwoHome){
-            stPos.uiRowIndex = stNewPos.uiRowIndex-uiMoves; stPos.uiMovesLeft = 0;
-        }
-    } else if (stGame->eTurn == PlayerThree){
-        if (stGame->Field[stNewPos.uiRowIndex+uiMoves][stNewPos.uiColIndex].eData == PlayerThreeHome){
-            stPos.uiRowIndex = stNewPos.uiRowIndex+uiMoves; stPos.uiMovesLeft = 0;
-        }
-    } else if (stGame->eTurn == PlayerFour){
-        if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex-uiMoves].eData == PlayerFourHome){
-            stPos.uiColIndex = stNewPos.uiColIndex-uiMoves; stPos.uiMovesLeft = 0;
+    TASK_BEGIN(pstTask);
+    while (true){
+        TASK_WAIT(pstTask, TaskFrame);
+        if (pstFlow->xAwaitingThrow){
+            UpdateHints(pstFlow->stGame, pstFlow->stHints);
         }
     }
-
-    return stPos;
+    TASK_END(pstTask);
 }
 
-bool CheckWinner(tStGame *stGame)
+// The field outlines and empty fields never change, they are tessellated once and drawn in place every frame
+static bool BuildStaticBoard(tStGame *stGame)
 {
-    unsigned short uiI = stGame->uiFieldWidth / 2;
-    unsigned short uiJ = stGame->uiFieldHeight / 2;
-
-    for (int j=1; j<5; j++){ // Amount of home positions
-        if (stGame->eTurn == PlayerOne && stGame->Field[uiI][uiJ-j].eData != PlayerOne){
-            return false;
-        } else if (stGame->eTurn == PlayerTwo && stGame->Field[uiI+j][uiJ].eData != PlayerTwo){
-            return false;
-        } else if (stGame->eTurn == PlayerThree && stGame->Field[uiI-j][uiJ].eData != PlayerThree){
-            return false;
-        } else if (stGame->eTurn == PlayerFour && stGame->Field[uiI][uiJ+j].eData != PlayerFour){
-            return false;
-        }
+    if (!RenderStaticBegin()){
+        return false;
     }
 
-    return true;
-}
+	for (int i=0; i<stGame->uiFieldHeight; i++){
+		for (int j=0; j<stGame->uiFieldWidth; j++){
+            if (stGame->Field[i][j].eData != NoPosition){
+                RenderCircle(stGame->Field[i][j].uiX, stGame->Field[i][j].uiY, stGame->uiCellHeight/2, BLACK);
+                RenderCircle(stGame->Field[i][j].uiX, stGame->Field[i][j].uiY, stGame->uiCellHeight/2*90/100, GetColor(Empty));
+            }
+		}
+	}
 
-unsigned short GetDistToHomePos(tStGame *stGame, tStPosition stOldPos)
-{
-    tStPosition stNewPos = MovePawn(stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, 8*stGame->uiFieldWidth / 2); // 8 * 5 is maximum amount of steps possible
-    return 8*stGame->uiFieldWidth / 2 - stNewPos.uiMovesLeft;
+    RenderStaticEnd();
+    return true;
 }
 
-tStPosition PickPawnComputer(tStGame *stGame, unsigned short uiDice)
+static void DrawDebugLine(vita2d_pgf *pstFont, unsigned short uiLine, const char *pcFormat, ...)
 {
-    tStPosition astPos[4];
-    tStPosition stBestPos = {-1, -1, 0};
-    unsigned short n = 0;
-    unsigned short uiDist = 9999;
+    char acText[64];
+    va_list args;
 
-    // Get all the pawns that are on the board
-    for (int i=0; i<stGame->uiFieldHeight; i++){
-        for (int j=0; j<stGame->uiFieldWidth; j++){
-            if (((i>3 && i<7) || (j>3 && j<7)) && stGame->Field[i][j].eData == stGame->eTurn){
-                if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2){ // Exclude (home positions) out of check
-                    astPos[n].uiRowIndex = i; astPos[n].uiColIndex = j;
-                    n++;
-                } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){ // The edges of the excluded area hold valid pawn locations
-                    astPos[n].uiRowIndex = i; astPos[n].uiColIndex = j;
-                    n++;
-                }
-            }
-        }
-    }
-
-    // Find out what pawn has to walk the shortest distance to the home pos
-    unsigned short k[4] = {99, 99, 99, 99};
-    for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
-        k[i] = GetDistToHomePos(stGame, astPos[i]);
-        if(k[i] < uiDist){
-            uiDist = k[i];
-            stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
-        }
-    }
-
-    // If computer is able to hit pawn which is not his own, hit that pawn OR If pawn cannot enter the home pos because of incorrect pips choose other pawn to move
-    for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
-        tStPosition stTemp = MovePawn(stGame, astPos[i].uiRowIndex, astPos[i].uiColIndex, uiDice);
-        if(stGame->Field[stTemp.uiRowIndex][stTemp.uiColIndex].eData % POFF == 0 && stTemp.uiMovesLeft == 0){ // Modulus of POFF means it hit one of the four players){
-            if(stGame->Field[stTemp.uiRowIndex][stTemp.uiColIndex].eData != stGame->eTurn){
-                stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
-            }
-        } else{
-            tStPosition stTemp2 = SetPlayerInHome(stGame, stTemp);
-            if (stTemp2.uiMovesLeft != 0){ // Pawn cannot enter home pos find second closest pawn to home pos
-                unsigned short uiTemp1 = 9999;
-                unsigned short uiTemp2 = 9999;
-                for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
-                    if(k[i] <= uiTemp1){
-                        uiTemp2 = uiTemp1;
-                        uiTemp1 = k[i];
-                    } else if(k[i] <= uiTemp2){
-                        uiTemp2 = k[i];
-                    }
-                }
-                for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
-                    if(k[i] == uiTemp2){
-                        stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
-                    }
-                }
-            }
-        }
-    }
-
-    return stBestPos;
+    va_start(args, pcFormat);
+    vsnprintf(acText, sizeof(acText), pcFormat, args);
+    va_end(args);
+    vita2d_pgf_draw_text(pstFont, DEBUG_X, DEBUG_Y + uiLine*DEBUG_LINE, WHITE, DEBUG_SCALE, acText);
 }
 
 int main(void)
 {
 	vita2d_init();
     startInput();
-    bool xAniDone = true;
-    bool xAniInit = false;
-    unsigned short uiDice = 0;
-    unsigned short uiI = 0;
-    unsigned short uiJ = 0;
-    unsigned short uiNrOfMaxPips = 0;
-    tEnumGameState eGameplayState = Waiting;
 
-    SceDateTime Time;
     tStGame stGame;
-    stGamePad stMcd;
-    tStPosition stPos = {-1, -1, 0};
+    stGamePad stMcd = {0};
     tStPosition stAniPos = {-1, -1, 0};   
+    tStHints stHints;
+    tStHistory stHistory;
+    static tStWinMeter stMeter; // Holds a second board, keep it off the stack
+    static tStTurnFlow stFlow;
+    tStScheduler stScheduler;
+    SceDateTime Time;
+    bool xShowMeter = false;
+    bool xShowDebug = false;
+    vita2d_pgf *pstFont = vita2d_load_default_pgf();
+    ResetHints(&stHints);
+    HistoryReset(&stHistory);
     stGame.eTurn = PlayerOne;
     sceRtcGetCurrentClockLocalTime(&Time);
-    srand(sceRtcGetMicrosecond(&Time));
+    SeedDice(&stGame, sceRtcGetMicrosecond(&Time));
 
-    stGame.uiFieldHeight = 11;
-    stGame.uiFieldWidth = 11;
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
     BoardConstructor(&stGame);
     BoardInitializer(&stGame);
+    RaceTableBuild();
+    EvaluatorInit(&stGame);
+    StrategyInit(sceKernelGetProcessTimeWide);
+    RenderInit();
+    bool xStaticBoard = BuildStaticBoard(&stGame);
+    HistoryPush(&stHistory, &stGame);
+    WinMeterInit(&stMeter, &stGame);
+    WinMeterRestart(&stMeter, &stGame, sceKernelGetProcessTimeWide);
+
+    stFlow.stGame = &stGame;
+    stFlow.stMcd = &stMcd;
+    stFlow.stHints = &stHints;
+    stFlow.stHistory = &stHistory;
+    stFlow.stMeter = &stMeter;
+    stFlow.stPos.uiRowIndex = -1;
+    stFlow.stPos.uiColIndex = -1;
+    stFlow.xAniDone = true;
+    TaskInit(&stScheduler);
+    TaskAdd(&stScheduler, &stFlow.stTask, PlayTurns, &stFlow);
+    TaskAdd(&stScheduler, &stFlow.stHintTask, PrecomputeHints, &stFlow);
+    MemLock(true); // Everything is allocated, the frame loop has to run without the heap
 
 	while(!stMcd.stButt[6].xTrigger)
 	{
+        MemNextFrame();
 		vita2d_start_drawing();
 		vita2d_clear_screen();
 
         inputRead(&stMcd);
+        stFlow.stStats.uiFrame++;
 
         if (stMcd.stDpad[0].xTrigger)
         {
             if (stMcd.stDpad[0].xLeft || stMcd.stDpad[0].xRight)
             {
-                stMcd.stDpad[0].xLeft == 0 ? uiJ++ : uiJ--;
-                uiJ = limit(stGame.uiFieldWidth-1, 0, uiJ);
+                stMcd.stDpad[0].xLeft == 0 ? stFlow.uiJ++ : stFlow.uiJ--;
+                stFlow.uiJ = limit(stGame.uiFieldWidth-1, 0, stFlow.uiJ);
             }
             else
             {
-                stMcd.stDpad[0].xUp == 0 ? uiI++ : uiI--;
-                uiI = limit(stGame.uiFieldHeight-1, 0, uiI);
+                stMcd.stDpad[0].xUp == 0 ? stFlow.uiI++ : stFlow.uiI--;
+                stFlow.uiI = limit(stGame.uiFieldHeight-1, 0, stFlow.uiI);
             }
         }
 
         if (stMcd.stTouch[0].xTrigger)
         {
-            float rDist = 0;
-            float rClosest = WIDTH;
-
-            for (int i=0; i<stGame.uiFieldHeight; i++){
-                for (int j=0; j<stGame.uiFieldWidth; j++){
-                    rDist = sqrtf(powf(stGame.Field[i][j].uiX - stMcd.stTouch[0].uiX, 2) + powf(stGame.Field[i][j].uiY - stMcd.stTouch[0].uiY, 2));
-                    if (rDist < rClosest){
-                        rClosest = rDist;
-                        uiI = i; uiJ = j;
-                    }
-                }
+            tStPosition stTouched = GetClosestField(&stGame, stMcd.stTouch[0].uiX, stMcd.stTouch[0].uiY);
+
+            if (stTouched.uiColIndex <= stGame.uiFieldWidth){
+                stFlow.uiI = stTouched.uiRowIndex;
+                stFlow.uiJ = stTouched.uiColIndex;
             }
         } 
 
-        tStPosition stOldPos;
-        tStPosition stNewPos;
-
-        if (!CheckWinner(&stGame))
-        {
-            switch (eGameplayState){
-
-            case Waiting:
-                uiDice = 0;
-                if (stMcd.stButt[1].xTrigger || stMcd.stTouch[0].xTrigger || stGame.eTurn != PlayerOne){
-                    eGameplayState = ThrowingDice;
-                }
-                break;
-
-            case ThrowingDice:
-                eGameplayState = PickingPawn;
-                uiDice = RollDice();
-                stNewPos = SummonPawn(&stGame); // Was there already an pawn summoned ?
-
-                if (uiDice == 6 && uiNrOfMaxPips%2 == 0){ // Player threw 6
-                    eGameplayState = ThrewHighestPips; // Check if player is alllowed to move pawn or summon new one
-                } else if (uiNrOfMaxPips%2 == 1 && stGame.Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData == stGame.eTurn){ // Player already summoned new pawn
-                    eGameplayState = MovingPawn; // Force player to move the summoned pawn
-                    uiI = stNewPos.uiRowIndex; // Set row index to summoned pawn location
-                    uiJ = stNewPos.uiColIndex; // Set col index to summoned pawn location
-                }
-                
-                break;
-
-            case ThrewHighestPips:
-                eGameplayState = PickingPawn;
-                stOldPos = CheckStartPos(&stGame, stGame.eTurn, false);
-
-                if (stOldPos.uiColIndex <= stGame.uiFieldWidth){
-                    eGameplayState = SummoningPawn;
-                }
-                break;
-
-            case SummoningPawn:
-                eGameplayState = AnimatingPawn;
-                xAniInit = true;
-                stOldPos = CheckStartPos(&stGame, stGame.eTurn, false);
-                stNewPos = SummonPawn(&stGame);
-
-                stPos = CheckHit(&stGame, stNewPos, stOldPos);
-                uiNrOfMaxPips++;
-                break;
-
-            case PickingPawn:
-                if (stGame.eTurn == PlayerOne){
-                    stOldPos = ChoosePawn(&stGame, uiI, uiJ);
-
-                    if ((stMcd.stButt[1].xTrigger || stMcd.stTouch[0].xTrigger) && stOldPos.uiColIndex > stGame.uiFieldWidth){
-                        vita2d_draw_rectangle(0, 0, WIDTH, HEIGHT, RED);
-                    } else if (stMcd.stButt[1].xTrigger || stMcd.stTouch[0].xTrigger){
-
-                        tStPosition stTemp = MovePawn(&stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, uiDice);
-                        tStPosition stTemp2 = SetPlayerInHome(&stGame, stTemp);
-                        if (stTemp2.uiMovesLeft != 0){ // Pawn cannot enter home pos find second closest pawn to home pos
-                            vita2d_draw_rectangle(0, 0, WIDTH, HEIGHT, RED);
-                        } else{
-                            eGameplayState = MovingPawn;
-                        }    
-                    }
-
-
-                } else{
-                    eGameplayState = MovingPawn;
-                    stOldPos = PickPawnComputer(&stGame, uiDice);
-                    if (stOldPos.uiColIndex <= stGame.uiFieldWidth){
-                        uiI = stOldPos.uiRowIndex;
-                        uiJ = stOldPos.uiColIndex;
-                    }
-                }
-                
-                if (GetNumberOfSummonedPawns(&stGame) == 0){
-                    eGameplayState = EndingTurn;
-                }
-                
-                break;
-
-            case MovingPawn:
-                eGameplayState = AnimatingPawn;
-                uiNrOfMaxPips++;
-                xAniInit = true;
-
-                stOldPos = ChoosePawn(&stGame, uiI, uiJ);
-                stNewPos = MovePawn(&stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, uiDice);
-
-                if (stNewPos.uiMovesLeft == 0){
-                    stPos = CheckHit(&stGame, stNewPos, stOldPos);
-                } else{
-                    stPos = SetPlayerInHome(&stGame, stNewPos);
-                    if (stPos.uiMovesLeft == 0){
-                        stGame.Field[stOldPos.uiRowIndex][stOldPos.uiColIndex].eData = Empty; // Remove old traces of the current player
-                    } else{
-                        stPos = stOldPos; // Move is impossible do not move player
-                    }
-                }
-
-                break;
+        if (stMcd.stButt[3].xTrigger){ // Show or hide the win chance meter with Triangle
+            xShowMeter = !xShowMeter;
+        }
 
-            case AnimatingPawn:
-                xAniInit = false;
+        if (stMcd.stButt[7].xTrigger){ // Show or hide the debug overlay with Start
+            xShowDebug = !xShowDebug;
+        }
 
-                if (xAniDone){
-                    eGameplayState = uiDice == 6 ? Waiting : EndingTurn;
-                    stPos.uiColIndex = -1;
-                    stPos.uiRowIndex = -1;
-                }
-                break;
+        if (stMcd.stButt[0].xTrigger && stGame.Field[stFlow.uiI][stFlow.uiJ].eData/POFF > PlayerOne/POFF){ // Square switches the strategy of the computer player under the cursor
+            tEnumPlayer eSeat = stGame.Field[stFlow.uiI][stFlow.uiJ].eData/POFF*POFF;
+            StrategySetSeat(eSeat, (StrategyGetSeat(eSeat) + 1) % StrategyCount());
+        }
 
-            case EndingTurn:
-                eGameplayState = Waiting;
-                uiNrOfMaxPips = 0;
-                SwitchPlayer(&stGame);
-                break;
+        // Only the tasks whose event was raised run, the turn flow sleeps while nothing happens
+        if (IsAnyTrigger(&stMcd)){
+            TaskSignal(&stScheduler, TaskInput);
+        }
+        TaskSignal(&stScheduler, TaskFrame);
+        TaskRun(&stScheduler);
 
-            default :
-                break;
-            }
-        } else{
-            if(stMcd.stButt[2].xTrigger){
-                BoardDestructor(&stGame);
-                BoardConstructor(&stGame);
-                BoardInitializer(&stGame);
-                sceRtcGetCurrentClockLocalTime(&Time);
-                srand(sceRtcGetMicrosecond(&Time));
-                eGameplayState = Waiting;
-            }
+        // Playouts run before the frame is built, so they do not count as draw time
+        if (xShowMeter && !CheckWinner(&stGame)){
+            WinMeterUpdate(&stMeter, WINMETER_BUDGET_US, sceKernelGetProcessTimeWide);
         }
 
+        // Collect all shapes of this frame and submit them in one batch
+        RenderBegin();
+
         // Draw background
-        vita2d_draw_rectangle(stGame.Field[0][0].uiX-stGame.uiCellWidth/2, stGame.Field[0][0].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth*stGame.uiFieldWidth, stGame.uiCellHeight*stGame.uiFieldHeight, ALMOND);
+        RenderRect(stGame.Field[0][0].uiX-stGame.uiCellWidth/2, stGame.Field[0][0].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth*stGame.uiFieldWidth, stGame.uiCellHeight*stGame.uiFieldHeight, ALMOND);
 
         // Draw current 'mouse' position
-        if (stGame.eTurn == PlayerOne){
-            vita2d_draw_rectangle(stGame.Field[uiI][uiJ].uiX-stGame.uiCellWidth/2, stGame.Field[uiI][uiJ].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, RED);
-        } else if (stGame.eTurn == PlayerTwo){
-            vita2d_draw_rectangle(stGame.Field[uiI][uiJ].uiX-stGame.uiCellWidth/2, stGame.Field[uiI][uiJ].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, YELLOW);
-        } else if (stGame.eTurn == PlayerThree){
-            vita2d_draw_rectangle(stGame.Field[uiI][uiJ].uiX-stGame.uiCellWidth/2, stGame.Field[uiI][uiJ].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, BLUE);
-        } else if (stGame.eTurn == PlayerFour){
-            vita2d_draw_rectangle(stGame.Field[uiI][uiJ].uiX-stGame.uiCellWidth/2, stGame.Field[uiI][uiJ].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, GREEN);
-        }
+        RenderRect(stGame.Field[stFlow.uiI][stFlow.uiJ].uiX-stGame.uiCellWidth/2, stGame.Field[stFlow.uiI][stFlow.uiJ].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, GetColor(stGame.eTurn));
 
         // Draw dice
-        vita2d_draw_rectangle(stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiX-stGame.uiCellWidth/2, stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, BLACK);
-        vita2d_draw_rectangle(stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiX-stGame.uiCellWidth/2+2, stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiY-stGame.uiCellHeight/2+2, stGame.uiCellWidth-4, stGame.uiCellHeight-4, WHITE);
+        RenderRect(stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiX-stGame.uiCellWidth/2, stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiY-stGame.uiCellHeight/2, stGame.uiCellWidth, stGame.uiCellHeight, BLACK);
+        RenderRect(stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiX-stGame.uiCellWidth/2+2, stGame.Field[stGame.uiFieldHeight/2][stGame.uiFieldWidth/2].uiY-stGame.uiCellHeight/2+2, stGame.uiCellWidth-4, stGame.uiCellHeight-4, WHITE);
 
 		for (int i=-1; i<2; i++){
 			for (int j=-1; j<2; j++){
-                if ((uiDice == 1 || uiDice == 3 || uiDice == 5) && j == 0 && i == 0){
-                    vita2d_draw_fill_circle(stGame.Field[5][5].uiX+j*15, stGame.Field[5][5].uiY+i*15, 5, BLACK);
-                }
-                
-                if ((uiDice == 2 || uiDice == 3) && ((j == -1 && i == 1) || (j == 1 && i == -1))){
-                    vita2d_draw_fill_circle(stGame.Field[5][5].uiX+j*15, stGame.Field[5][5].uiY+i*15, 5, BLACK);
+                if (((stFlow.uiDice == 1 || stFlow.uiDice == 3 || stFlow.uiDice == 5) && j == 0 && i == 0) ||
+                    ((stFlow.uiDice == 2 || stFlow.uiDice == 3) && ((j == -1 && i == 1) || (j == 1 && i == -1))) ||
+                    ((stFlow.uiDice == 4 || stFlow.uiDice == 5 || stFlow.uiDice == 6) && i != 0 && j != 0) ||
+                    (stFlow.uiDice == 6 && ((j == -1 && i == 0) || (j == 1 && i == 0)))){
+                    RenderCircle(stGame.Field[5][5].uiX+j*15, stGame.Field[5][5].uiY+i*15, 5, BLACK);
                 }
+            }
+        }
 
-                if ((uiDice == 4 || uiDice == 5 || uiDice == 6) && i != 0 && j != 0){
-                    vita2d_draw_fill_circle(stGame.Field[5][5].uiX+j*15, stGame.Field[5][5].uiY+i*15, 5, BLACK);
-                }
+        // Draw board and pawns, pawns which are able to move are outlined
+        bool xShowHints = stFlow.xPicking;
 
-                if (uiDice == 6 && ((j == -1 && i == 0) || (j == 1 && i == 0))){
-                    vita2d_draw_fill_circle(stGame.Field[5][5].uiX+j*15, stGame.Field[5][5].uiY+i*15, 5, BLACK);
-                }
-            }
+        // Only pawns, colored fields and outlines differing from the static board are drawn per frame
+        if (xStaticBoard){
+            RenderStatic();
         }
 
-        // Draw board and pawns
 		for (int i=0; i<stGame.uiFieldHeight; i++){
 			for (int j=0; j<stGame.uiFieldWidth; j++){
                 if (stGame.Field[i][j].eData != NoPosition){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2, BLACK);
-                }
-                
-                if (stGame.Field[i][j].eData == Empty){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, WHITE);
-				} else if (stGame.Field[i][j].eData == PlayerOne){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, RED);
-                } else if (stGame.Field[i][j].eData == PlayerOneHome){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, RGBA8(255/2,   0,   0, 255));
-				} else if (stGame.Field[i][j].eData == PlayerTwo){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, YELLOW);
-                } else if (stGame.Field[i][j].eData == PlayerTwoHome){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, RGBA8(255/2, 255/2, 0, 255));
-				} else if (stGame.Field[i][j].eData == PlayerThree){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, BLUE);
-                } else if (stGame.Field[i][j].eData == PlayerThreeHome){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, RGBA8(0,   0,   255/2, 255));
-				} else if (stGame.Field[i][j].eData == PlayerFour){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, GREEN);
-                } else if (stGame.Field[i][j].eData == PlayerFourHome){
-                    vita2d_draw_fill_circle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, RGBA8(0,   255/2,   0, 255));
+                    bool xHint = xShowHints && IsHintLegal(&stHints, stFlow.uiDice, i, j);
+                    if (!xStaticBoard || xHint){
+                        RenderCircle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2, xHint ? WHITE : BLACK);
+                    }
+                    if (!xStaticBoard || xHint || stGame.Field[i][j].eData != Empty){
+                        RenderCircle(stGame.Field[i][j].uiX, stGame.Field[i][j].uiY, stGame.uiCellHeight/2*90/100, GetColor(stGame.Field[i][j].eData));
+                    }
                 }
 			}
 		}
 
+        // Draw recommended pawn
+        if (xShowHints && stHints.astBest[stFlow.uiDice].uiColIndex <= stGame.uiFieldWidth){
+            RenderCircle(stGame.Field[stHints.astBest[stFlow.uiDice].uiRowIndex][stHints.astBest[stFlow.uiDice].uiColIndex].uiX, stGame.Field[stHints.astBest[stFlow.uiDice].uiRowIndex][stHints.astBest[stFlow.uiDice].uiColIndex].uiY, stGame.uiCellHeight/6, WHEAT);
+        }
+
         // Animate Pawn
-        if (stPos.uiColIndex <= stGame.uiFieldWidth){
+        if (stFlow.stPos.uiColIndex <= stGame.uiFieldWidth){
             static float rPosX;
             static float rPosY;
             static float rPsi;
 
-            if (xAniInit){
-                stAniPos = stOldPos;
+            if (stFlow.xAniInit){
+                stAniPos = stFlow.stOldPos;
                 rPosX = stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiX;
                 rPosY = stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiY;
-                rPsi = atan2f((stGame.Field[stPos.uiRowIndex][stPos.uiColIndex].uiY-stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiY),(stGame.Field[stPos.uiRowIndex][stPos.uiColIndex].uiX-stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiX));
+                rPsi = atan2f((stGame.Field[stFlow.stPos.uiRowIndex][stFlow.stPos.uiColIndex].uiY-stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiY),(stGame.Field[stFlow.stPos.uiRowIndex][stFlow.stPos.uiColIndex].uiX-stGame.Field[stAniPos.uiRowIndex][stAniPos.uiColIndex].uiX));
+                stFlow.xAniInit = false;
             }
 
             float rAniSpeed = 2.5; // 2.5 pixels per frame is approximately 150 pixels per sec
-            float rDist = sqrtf(powf(stGame.Field[stPos.uiRowIndex][stPos.uiColIndex].uiX-rPosX, 2) + powf(stGame.Field[stPos.uiRowIndex][stPos.uiColIndex].uiY-rPosY, 2));
+            float rDist = sqrtf(powf(stGame.Field[stFlow.stPos.uiRowIndex][stFlow.stPos.uiColIndex].uiX-rPosX, 2) + powf(stGame.Field[stFlow.stPos.uiRowIndex][stFlow.stPos.uiColIndex].uiY-rPosY, 2));
             rPosX += rAniSpeed * cosf(rPsi);
             rPosY += rAniSpeed * sinf(rPsi);
 
-            if (stGame.eTurn == PlayerOne){
-                vita2d_draw_fill_circle(rPosX, rPosY, stGame.uiCellHeight/2*90/100, RED);
-            } else if (stGame.eTurn == PlayerTwo){
-                vita2d_draw_fill_circle(rPosX, rPosY, stGame.uiCellHeight/2*90/100, YELLOW);
-            } else if (stGame.eTurn == PlayerThree){
-                vita2d_draw_fill_circle(rPosX, rPosY, stGame.uiCellHeight/2*90/100, BLUE);
-            } else if (stGame.eTurn == PlayerFour){
-                vita2d_draw_fill_circle(rPosX, rPosY, stGame.uiCellHeight/2*90/100, GREEN);
-            }
+            RenderCircle(rPosX, rPosY, stGame.uiCellHeight/2*90/100, GetColor(stGame.eTurn));
             
             if (rDist < rAniSpeed){
-                stGame.Field[stPos.uiRowIndex][stPos.uiColIndex].eData = stGame.eTurn; // Set current player to the new pos
-                xAniDone = true;
+                stGame.Field[stFlow.stPos.uiRowIndex][stFlow.stPos.uiColIndex].eData = stGame.eTurn; // Set current player to the new pos
+                stFlow.xAniDone = true;
+                TaskSignal(&stScheduler, TaskAnimation); // Wakes the turn flow in the next frame
+            }
+        }
+
+        // Draw win chance per player in the left margin, the thin bar marks the 95% interval
+        if (xShowMeter){
+            for (tEnumPlayer ePlayer=PlayerOne; ePlayer<=PlayerFour; ePlayer+=POFF){
+                float rHalfWidth;
+                float rChance = WinMeterChance(&stMeter, ePlayer, &rHalfWidth);
+                float rLow = rChance - rHalfWidth < 0 ? 0 : rChance - rHalfWidth;
+                float rHigh = rChance + rHalfWidth > 1 ? 1 : rChance + rHalfWidth;
+                short uiY = stGame.Field[0][0].uiY + (ePlayer/POFF-1)*stGame.uiCellHeight;
+
+                RenderRect(10, uiY, 100, stGame.uiCellHeight/2, BLACK);
+                RenderRect(10, uiY, 100*rChance, stGame.uiCellHeight/2, GetColor(ePlayer));
+                RenderRect(10 + 100*rLow, uiY + stGame.uiCellHeight/2 + 2, 100*(rHigh-rLow) + 1, 2, WHITE);
+            }
+        }
+
+        RenderFlush();
+
+        // Debug overlay, drawn after the batch so it stays on top
+        if (xShowDebug){
+            unsigned int uiHints = stHints.uiHits + stHints.uiMisses;
+            tStRenderStats stRender = RenderGetStats();
+            DrawDebugLine(pstFont, 0, "hint ready %llu us", stHints.ulFirstHintUs);
+            DrawDebugLine(pstFont, 1, "hint hits %u/%u (%u%%)", stHints.uiHits, uiHints, uiHints > 0 ? stHints.uiHits*100/uiHints : 0);
+            DrawDebugLine(pstFont, 2, "draws %u shapes %u", stRender.uiDraws, stRender.uiPrimitives);
+            DrawDebugLine(pstFont, 3, "vertices %u, static %u", stRender.uiVertices, stRender.uiStaticVertices);
+            DrawDebugLine(pstFont, 4, "draw time %llu us", stRender.ulDrawTimeUs);
+            DrawDebugLine(pstFont, 5, "playouts %.0f/s", WinMeterPlayoutsPerSec(&stMeter));
+            if (stMeter.ulConvergeUs > 0){
+                DrawDebugLine(pstFont, 6, "meter settled in %llu ms", stMeter.ulConvergeUs/1000);
             } else{
-                xAniDone = false;
+                DrawDebugLine(pstFont, 6, "meter settling, %u playouts", stMeter.uiPlayouts);
             }
+            DrawDebugLine(pstFont, 7, "latency %.1f fr, max %u", stFlow.stStats.uiMoves > 0 ? (float)stFlow.stStats.uiLatencyFrames / stFlow.stStats.uiMoves : 0, stFlow.stStats.uiMaxLatencyFrames);
+            DrawDebugLine(pstFont, 8, "tasks run %u, idle %u", stScheduler.uiResumes, stScheduler.uiSkips);
         }
 
 		vita2d_wait_rendering_done();
@@ -794,5 +635,9 @@ int main(void)
 		vita2d_swap_buffers();
         sceDisplayWaitVblankStart();
 	}
+
+    MemLock(false);
+    vita2d_free_pgf(pstFont);
+    BoardDestructor(&stGame);
 	return 0;
 }
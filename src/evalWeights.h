@@ -0,0 +1,7 @@
+#ifndef EVALWEIGHTS_H
+#define EVALWEIGHTS_H
+
+// Generated by tools/tdTrainer.c after 20000 self-play games, do not edit by hand
+static const signed char aiEvalWeights[EVAL_FEATURES] = {-65, 66, -74, -21, 1, -127, -33, 86};
+
+#endif
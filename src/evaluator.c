@@ -0,0 +1,163 @@
+#include "evaluator.h"
+#include "evalWeights.h"
+
+static signed char aaiTrack[FIELD_SIZE][FIELD_SIZE]; // Index of every field on the track counted from the start of PlayerOne, -1 when not on the track
+static short aiHomeEntry[5]; // Track index of the home entry per player
+
+void EvaluatorInit(tStGame *stGame)
+{
+    tEnumPlayer eTurn = stGame->eTurn;
+    tStPosition stPos;
+
+    for (int i=0; i<FIELD_SIZE; i++){
+        for (int j=0; j<FIELD_SIZE; j++){
+            aaiTrack[i][j] = -1;
+        }
+    }
+
+    // Walk the track one field at a time, NoPosition never stops at a home entry
+    stGame->eTurn = PlayerOne;
+    stPos = SummonPawn(stGame);
+    stGame->eTurn = NoPosition;
+    for (int k=0; k<40; k++){
+        aaiTrack[stPos.uiRowIndex][stPos.uiColIndex] = k;
+        stPos = MovePawn(stGame, stPos.uiRowIndex, stPos.uiColIndex, 1);
+    }
+    stGame->eTurn = eTurn;
+
+    for (tEnumPlayer ePlayer=PlayerOne; ePlayer<=PlayerFour; ePlayer+=POFF){
+        stPos = GetHomeSlot(stGame, ePlayer, 0); // Slot 0 is the home entry on the track itself
+        aiHomeEntry[ePlayer/POFF] = aaiTrack[stPos.uiRowIndex][stPos.uiColIndex];
+    }
+    MemStatic(sizeof(aaiTrack) + sizeof(aiHomeEntry), MemEvaluator);
+}
+
+static void GetBoardFeatures(const unsigned char *auiData, tEnumPlayer ePlayer, short *aiFeatures)
+{
+    short aaiPawn[5][4]; // Track index of every pawn on the track per player
+    short aaiDist[5][4]; // Distance to the home entry of every pawn on the track per player
+    short auiNrOfPawns[5] = {0};
+    short auiHome[5] = {0};
+    short auiProgress[5] = {0};
+    short auiSquared[5] = {0}; // Grows faster when the leading pawn advances than when the pawns are spread out
+    short uiOwn = ePlayer/POFF;
+
+    for (int i=0; i<FIELD_SIZE; i++){
+        for (int j=0; j<FIELD_SIZE; j++){
+            tEnumPlayer eData = auiData[i*FIELD_SIZE+j];
+            if (eData % POFF == 0 && eData != NoPosition){
+                short p = eData/POFF;
+                if (aaiTrack[i][j] >= 0){
+                    aaiPawn[p][auiNrOfPawns[p]] = aaiTrack[i][j];
+                    aaiDist[p][auiNrOfPawns[p]] = (aiHomeEntry[p] - aaiTrack[i][j] + 40) % 40;
+                    auiProgress[p] += 40 - aaiDist[p][auiNrOfPawns[p]];
+                    auiSquared[p] += (40 - aaiDist[p][auiNrOfPawns[p]])*(40 - aaiDist[p][auiNrOfPawns[p]])/44;
+                    auiNrOfPawns[p]++;
+                } else if ((i == FIELD_SIZE/2 || j == FIELD_SIZE/2)){ // Pawn in a home position
+                    auiHome[p]++;
+                    auiProgress[p] += 44;
+                    auiSquared[p] += 44;
+                }
+            }
+        }
+    }
+
+    // Pawns which can be hit with one throw of the dice
+    short uiAtRisk = 0;
+    short uiThreats = 0;
+    for (int p=1; p<5; p++){
+        for (int a=0; p != uiOwn && a<auiNrOfPawns[p]; a++){
+            for (int b=0; b<auiNrOfPawns[uiOwn]; b++){
+                short uiGap = (aaiPawn[uiOwn][b] - aaiPawn[p][a] + 40) % 40;
+                if (uiGap > 0 && uiGap < 7 && aaiDist[p][a] >= uiGap){
+                    uiAtRisk++;
+                }
+                uiGap = (aaiPawn[p][a] - aaiPawn[uiOwn][b] + 40) % 40;
+                if (uiGap > 0 && uiGap < 7 && aaiDist[uiOwn][b] >= uiGap){
+                    uiThreats++;
+                }
+            }
+        }
+    }
+
+    short uiBestOther = 0;
+    for (int p=1; p<5; p++){
+        if (p != uiOwn){
+            uiBestOther = auiProgress[p] > uiBestOther ? auiProgress[p] : uiBestOther;
+        }
+    }
+
+    aiFeatures[0] = 64; // Bias
+    aiFeatures[1] = auiProgress[uiOwn];
+    aiFeatures[2] = (4 - auiNrOfPawns[uiOwn] - auiHome[uiOwn])*16; // Pawns in the start area
+    aiFeatures[3] = uiAtRisk*16;
+    aiFeatures[4] = uiThreats*16;
+    aiFeatures[5] = uiBestOther;
+    aiFeatures[6] = auiNrOfPawns[uiOwn]*16; // Pawns exposed on the track
+    aiFeatures[7] = auiSquared[uiOwn];
+}
+
+void GetFeatures(tStGame *stGame, tEnumPlayer ePlayer, short *aiFeatures)
+{
+    tStSnapshot stSnapshot;
+
+    SaveSnapshot(stGame, &stSnapshot);
+    GetBoardFeatures(stSnapshot.auiData, ePlayer, aiFeatures);
+}
+
+static int GetScore(const short *aiFeatures)
+{
+    int iScore = 0;
+
+    for (int k=0; k<EVAL_FEATURES; k++){
+        iScore += aiFeatures[k] * aiEvalWeights[k];
+    }
+
+    return iScore;
+}
+
+int EvaluatePosition(tStGame *stGame, tEnumPlayer ePlayer)
+{
+    short aiFeatures[EVAL_FEATURES];
+
+    GetFeatures(stGame, ePlayer, aiFeatures);
+    return GetScore(aiFeatures);
+}
+
+void EvaluateBatch(const tStSnapshot *astPositions, unsigned int uiCount, tEnumPlayer ePlayer, int *aiScores)
+{
+    short aiFeatures[EVAL_FEATURES];
+
+    for (unsigned int n=0; n<uiCount; n++){
+        GetBoardFeatures(astPositions[n].auiData, ePlayer, aiFeatures);
+        aiScores[n] = GetScore(aiFeatures);
+    }
+}
+
+tStPosition PickPawnEvaluator(tStGame *stGame, unsigned short uiDice)
+{
+    tStPosition stBestPos = {-1, -1, 0};
+    int iBest = 0;
+
+    // Try every pawn which is able to move and keep the one that leads to the best position
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            tStPosition stPawn = ChoosePawn(stGame, i, j);
+            tStMove stMove;
+            if (stPawn.uiColIndex <= stGame->uiFieldWidth && MakeMove(stGame, stPawn, uiDice, &stMove)){
+                int iScore = EvaluatePosition(stGame, stGame->eTurn);
+                UnmakeMove(stGame, &stMove);
+                if (stBestPos.uiColIndex > stGame->uiFieldWidth || iScore > iBest){
+                    iBest = iScore;
+                    stBestPos = stPawn;
+                }
+            }
+        }
+    }
+
+    if (stBestPos.uiColIndex > stGame->uiFieldWidth){ // No pawn is able to move, leave it to the greedy rule
+        return PickPawnComputer(stGame, uiDice);
+    }
+
+    return stBestPos;
+}
@@ -0,0 +1,14 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "gameRules.h"
+
+#define EVAL_FEATURES 8 // Length of the feature vector, keep it a multiple of 4 for vectorised dot products
+
+void EvaluatorInit(tStGame *stGame);
+void GetFeatures(tStGame *stGame, tEnumPlayer ePlayer, short *aiFeatures);
+int EvaluatePosition(tStGame *stGame, tEnumPlayer ePlayer);
+void EvaluateBatch(const tStSnapshot *astPositions, unsigned int uiCount, tEnumPlayer ePlayer, int *aiScores);
+tStPosition PickPawnEvaluator(tStGame *stGame, unsigned short uiDice);
+
+#endif
@@ -0,0 +1,762 @@
+#include "gameRules.h"
+
+void BoardConstructor(tStGame *stGame)
+{
+    BoardConstructorTagged(stGame, MemBoard);
+}
+
+void BoardConstructorTagged(tStGame *stGame, tEnumMemTag eTag)
+{
+	stGame->uiCellHeight = HEIGHT / stGame->uiFieldHeight;
+	stGame->uiCellWidth = stGame->uiCellHeight;
+
+    unsigned short uiIncreaseRow = 0;
+	stGame->Field = MemAlloc(sizeof(tStBoard *)*stGame->uiFieldHeight, eTag);
+
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        uiIncreaseRow += i == 0 ? stGame->uiCellHeight/2 : stGame->uiCellHeight;
+        stGame->Field[i] = MemAlloc(sizeof(tStBoard)*stGame->uiFieldWidth, eTag);
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            stGame->Field[i][j].eData = NoPosition;
+            stGame->Field[i][j].uiY = uiIncreaseRow;
+            stGame->Field[i][j].uiX = j == 0 ? (WIDTH-(stGame->uiCellWidth*stGame->uiFieldWidth))/2 : stGame->Field[i][j-1].uiX + stGame->uiCellWidth;
+        }
+    }
+}
+
+void BoardDestructor(tStGame *stGame)
+{
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        MemFree(stGame->Field[i]);
+    }
+    MemFree(stGame->Field);
+}
+
+void SaveSnapshot(tStGame *stGame, tStSnapshot *pstSnapshot)
+{
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            pstSnapshot->auiData[i*FIELD_SIZE+j] = stGame->Field[i][j].eData;
+        }
+    }
+    pstSnapshot->eTurn = stGame->eTurn;
+}
+
+void LoadSnapshot(tStGame *stGame, const tStSnapshot *pstSnapshot)
+{
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            stGame->Field[i][j].eData = pstSnapshot->auiData[i*FIELD_SIZE+j];
+        }
+    }
+    stGame->eTurn = pstSnapshot->eTurn;
+}
+
+void CreatePlayers(tStGame *stGame)
+{
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            if (i%(stGame->uiFieldHeight-2) < 2 && j%(stGame->uiFieldWidth-2) < 2){
+                if (i < 2 && j < 2){
+                   stGame->Field[i][j].eData = PlayerOne;
+                } else if (i > 8 && j < 2){
+                    stGame->Field[i][j].eData = PlayerTwo;
+                } else if (i < 2 && j > 8){
+                    stGame->Field[i][j].eData = PlayerThree;
+                } else if (i > 8 && j > 8){
+                    stGame->Field[i][j].eData = PlayerFour;
+                }
+            }
+        }
+    }
+}
+
+void CreatePlayingCircle(tStGame *stGame)
+{
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            if ((i>3 && i<7) || (j>3 && j<7)){  
+                stGame->Field[i][j].eData = Empty;
+            }
+        }
+    }
+}
+
+void CreateHomePositions(tStGame *stGame)
+{
+    unsigned short uiI = stGame->uiFieldWidth / 2;
+    unsigned short uiJ = stGame->uiFieldHeight / 2;
+    stGame->Field[uiI][uiJ].eData = NoPosition;
+
+    for (int i=0; i<4; i++){ // Amount of players
+        for (int j=1; j<5; j++){ // Amount of home positions
+            if (i == 0){
+                stGame->Field[uiI][uiJ-j].eData = PlayerOneHome;
+            } else if (i == 1){
+                stGame->Field[uiI+j][uiJ].eData = PlayerTwoHome;
+            } else if (i == 2){
+                stGame->Field[uiI-j][uiJ].eData = PlayerThreeHome;
+            } else if (i == 3){
+                stGame->Field[uiI][uiJ+j].eData = PlayerFourHome;
+            }
+        }
+    }  
+}
+
+void CreateStartPositions(tStGame *stGame)
+{
+    stGame->Field[stGame->uiFieldHeight/2-1][0].eData = PlayerOneStart;
+    stGame->Field[stGame->uiFieldHeight-1][stGame->uiFieldWidth/2-1].eData = PlayerTwoStart;
+    stGame->Field[0][stGame->uiFieldWidth/2+1].eData = PlayerThreeStart;
+    stGame->Field[stGame->uiFieldHeight/2+1][stGame->uiFieldWidth-1].eData = PlayerFourStart;
+}
+
+void BoardInitializer(tStGame *stGame)
+{
+    CreatePlayers(stGame);
+    CreatePlayingCircle(stGame);
+    CreateHomePositions(stGame);
+    // CreateStartPositions(stGame);
+}
+
+void SeedDice(tStGame *stGame, unsigned int uiSeed)
+{
+    stGame->uiSeed = uiSeed != 0 ? uiSeed : 1; // Zero would make the generator stay at zero
+}
+
+unsigned short RollDice(tStGame *stGame)
+{
+    // Every game has its own xorshift generator so simulations do not change the dice of the real game
+    stGame->uiSeed ^= stGame->uiSeed << 13;
+    stGame->uiSeed ^= stGame->uiSeed >> 17;
+    stGame->uiSeed ^= stGame->uiSeed << 5;
+    return (stGame->uiSeed % 6) + 1;
+}
+
+tStPosition ChoosePawn(tStGame *stGame, unsigned short i, unsigned short j)
+{
+    tStPosition stPos = {-1, -1, 0};
+
+    if (stGame->Field[i][j].eData == stGame->eTurn){ // Did user selected his own pawn ?
+        if ((i>3 && i<7) || (j>3 && j<7)){ // Is the pawn on the field ?
+            if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2 ){ // Is the pawn not in the home position ?
+                stPos.uiRowIndex = i; stPos.uiColIndex = j;
+            } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){
+                stPos.uiRowIndex = i; stPos.uiColIndex = j;
+            }
+        }
+    }
+
+    return stPos;
+}
+
+tStPosition GetClosestField(tStGame *stGame, unsigned short uiX, unsigned short uiY)
+{
+    tStPosition stPos = {-1, -1, 0};
+    int iClosest = WIDTH*WIDTH; // Squared distances keep the same order and need no square root
+
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            int iDx = stGame->Field[i][j].uiX - uiX;
+            int iDy = stGame->Field[i][j].uiY - uiY;
+            if (iDx*iDx + iDy*iDy < iClosest){
+                iClosest = iDx*iDx + iDy*iDy;
+                stPos.uiRowIndex = i; stPos.uiColIndex = j;
+            }
+        }
+    }
+
+    return stPos;
+}
+
+tStPosition MovePawn(tStGame *stGame, unsigned short i, unsigned short j, unsigned short uiMoves)
+{
+    //             CLOCKWISE                              ANTI CLOCKWISE
+	// j0 j1 j2 j3 j4 j5 j6 j7 j8 j9 j10        j0 j1 j2 j3 j4 j5 j6 j7 j8 j9 j10
+	// [1][1][ ][ ][→][→][↓][ ][ ][3][3] i0     [1][1][ ][ ][↓][←][←][ ][ ][3][3] i0
+	// [1][1][ ][ ][↑][|][↓][ ][ ][3][3] i1     [1][1][ ][ ][↓][|][↑][ ][ ][3][3] i1
+	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i2     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i2
+	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i3     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i3
+	// [→][→][→][→][↑][|][→][→][→][→][↓] i4     [↓][←][←][←][←][|][↑][←][←][←][←] i4
+	// [↑][—][—][—][—][⚄][—][—][—][—][↓] i5     [↓][—][—][—][—][⚄][—][—][—][—][↑] i5
+	// [↑][←][←][←][←][|][↓][←][←][←][←] i6     [→][→][→][→][→][|][→][→][→][→][↑] i6
+	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i7     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i7
+	// [ ][ ][ ][ ][↑][|][↓][ ][ ][ ][ ] i8     [ ][ ][ ][ ][↓][|][↑][ ][ ][ ][ ] i8
+	// [2][2][ ][ ][↑][|][↓][ ][ ][4][4] i9     [2][2][ ][ ][↓][|][↑][ ][ ][4][4] i9
+	// [2][2][ ][ ][↑][←][←][ ][ ][4][4] i10    [2][2][ ][ ][→][→][↑][ ][ ][4][4] i10
+
+    bool xHomePos = false;
+    bool xPawnOnEdge = true;
+
+    if (stGame->eTurn == PlayerOne && i == stGame->uiFieldHeight/2 && j == 0){
+        xHomePos = true;
+    } else if (stGame->eTurn == PlayerTwo && i == stGame->uiFieldHeight-1 && j == stGame->uiFieldWidth/2){
+        xHomePos = true;
+    } else if (stGame->eTurn == PlayerThree && i == 0 && j == stGame->uiFieldWidth/2){
+        xHomePos = true;
+    } else if (stGame->eTurn == PlayerFour && i == stGame->uiFieldHeight/2 && j == stGame->uiFieldWidth-1){
+        xHomePos = true;
+    }
+    
+    if (uiMoves == 0 || xHomePos){
+        tStPosition stPos = {i, j, uiMoves};
+        return stPos;
+    }
+
+    if (i == stGame->uiFieldHeight/2-1 && j != stGame->uiFieldWidth/2-1 && j != stGame->uiFieldWidth-1){
+        xPawnOnEdge = false;
+        j++;
+    } else if (i == stGame->uiFieldHeight/2+1 && j != stGame->uiFieldWidth/2+1 && j != 0){
+        xPawnOnEdge = false;
+        j--;
+    } else if (j == stGame->uiFieldWidth/2-1 && i != stGame->uiFieldHeight/2+1 && i != 0){
+        xPawnOnEdge = false;
+        i--;
+    } else if (j == stGame->uiFieldWidth/2+1 && i != stGame->uiFieldHeight/2-1 && i != stGame->uiFieldHeight-1){
+        xPawnOnEdge = false;
+        i++;
+    }
+
+    if (xPawnOnEdge){
+        if (i == 0){
+            j++;
+        } else if (i == stGame->uiFieldHeight-1){
+            j--;
+        } else if (j == 0){
+            i--;
+        } else if (j == stGame->uiFieldWidth-1){
+            i++;
+        }
+    }
+
+    uiMoves--;
+    return MovePawn(stGame, i, j, uiMoves);
+}
+
+tStPosition CheckStartPos(tStGame *stGame, tEnumPlayer ePlayer, bool xFindEmptySpot)
+{
+    tStPosition stPos = {-1, -1, 0};
+
+    if (ePlayer == PlayerOne){
+        for (int i=0; i<2; i++){
+            for (int j=0; j<2; j++){
+                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerOne){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                }
+            }
+        }
+    } else if (ePlayer == PlayerTwo){
+        for (int i=stGame->uiFieldHeight-2; i<stGame->uiFieldHeight; i++){
+            for (int j=0; j<2; j++){
+                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerTwo){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                }
+            }
+        }
+    } else if (ePlayer == PlayerThree){
+        for (int i=0; i<2; i++){
+            for (int j=stGame->uiFieldWidth-2; j<stGame->uiFieldWidth; j++){
+                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerThree){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                }
+            }
+        }
+    }else if (ePlayer == PlayerFour){
+        for (int i=stGame->uiFieldHeight-2; i<stGame->uiFieldHeight; i++){
+            for (int j=stGame->uiFieldWidth-2; j<stGame->uiFieldWidth; j++){
+                if (xFindEmptySpot && stGame->Field[i][j].eData == Empty){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                } else if (!xFindEmptySpot && stGame->Field[i][j].eData == PlayerFour){
+                    stPos.uiRowIndex = i; stPos.uiColIndex = j;
+                }
+            }
+        }
+    }
+
+    return stPos;
+}
+
+void RemovePlayer(tStGame *stGame, tStPosition stNewPos)
+{
+    tStPosition stPos = CheckStartPos(stGame, stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData, true);
+    stGame->Field[stPos.uiRowIndex][stPos.uiColIndex].eData = stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData;
+}
+
+tStPosition CheckHit(tStGame *stGame, tStPosition stNewPos, tStPosition stOldPos)
+{
+    tStPosition stPos = stNewPos;
+
+    if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData % POFF == 0){ // Modulus of POFF means it hit one of the four players
+        RemovePlayer(stGame, stNewPos); // Place the hitted player back in the starting pos
+    }
+
+    // stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData = stGame->eTurn; // Set current player to the new pos
+    stGame->Field[stOldPos.uiRowIndex][stOldPos.uiColIndex].eData = Empty; // Remove old traces of the current player
+
+    return stPos;
+}
+
+void SwitchPlayer(tStGame *stGame)
+{
+    stGame->eTurn+= POFF;
+
+    if (stGame->eTurn > PlayerFour){
+        stGame->eTurn = POFF;
+    }
+}
+
+tStPosition SummonPawn(tStGame *stGame)
+{
+    tStPosition stPos = {-1, -1, 0};
+
+    if (stGame->eTurn == PlayerOne){
+        stPos.uiRowIndex = stGame->uiFieldHeight/2-1;
+        stPos.uiColIndex = 0;
+    } else if (stGame->eTurn == PlayerTwo){
+        stPos.uiRowIndex = stGame->uiFieldHeight-1;
+        stPos.uiColIndex = stGame->uiFieldWidth/2-1;
+    } else if (stGame->eTurn == PlayerThree){
+        stPos.uiRowIndex = 0;
+        stPos.uiColIndex = stGame->uiFieldWidth/2+1;
+    } else if (stGame->eTurn == PlayerFour){
+        stPos.uiRowIndex = stGame->uiFieldHeight/2+1;
+        stPos.uiColIndex = stGame->uiFieldWidth-1;
+    }
+
+    return stPos;
+}
+
+unsigned short GetNumberOfSummonedPawns(tStGame *stGame)
+{
+    unsigned short uiCount = 0;
+
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            if (((i>3 && i<7) || (j>3 && j<7)) && stGame->Field[i][j].eData == stGame->eTurn){
+                if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2){ // Exclude (home positions) out of check
+                    uiCount++;
+                } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){ // The edges of the excluded area hold valid pawn locations
+                    uiCount++;
+                }
+            }
+        }
+    }
+
+    return uiCount;
+}
+
+tStPosition SetPlayerInHome(tStGame *stGame, tStPosition stNewPos)
+{
+    tStPosition stPos = stNewPos;
+    unsigned short uiMoves = stNewPos.uiMovesLeft > 4 ? stNewPos.uiMovesLeft - (stNewPos.uiMovesLeft%4)*2 : stNewPos.uiMovesLeft;
+
+    if (stGame->eTurn == PlayerOne){
+        if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex+uiMoves].eData == PlayerOneHome){
+            stPos.uiColIndex = stNewPos.uiColIndex+uiMoves; stPos.uiMovesLeft = 0;
+        }
+    } else if (stGame->eTurn == PlayerTwo){
+        if (stGame->Field[stNewPos.uiRowIndex-uiMoves][stNewPos.uiColIndex].eData == PlayerTwoHome){
+            stPos.uiRowIndex = stNewPos.uiRowIndex-uiMoves; stPos.uiMovesLeft = 0;
+        }
+    } else if (stGame->eTurn == PlayerThree){
+        if (stGame->Field[stNewPos.uiRowIndex+uiMoves][stNewPos.uiColIndex].eData == PlayerThreeHome){
+            stPos.uiRowIndex = stNewPos.uiRowIndex+uiMoves; stPos.uiMovesLeft = 0;
+        }
+    } else if (stGame->eTurn == PlayerFour){
+        if (stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex-uiMoves].eData == PlayerFourHome){
+            stPos.uiColIndex = stNewPos.uiColIndex-uiMoves; stPos.uiMovesLeft = 0;
+        }
+    }
+
+    return stPos;
+}
+
+bool CheckWinner(tStGame *stGame)
+{
+    unsigned short uiI = stGame->uiFieldWidth / 2;
+    unsigned short uiJ = stGame->uiFieldHeight / 2;
+
+    for (int j=1; j<5; j++){ // Amount of home positions
+        if (stGame->eTurn == PlayerOne && stGame->Field[uiI][uiJ-j].eData != PlayerOne){
+            return false;
+        } else if (stGame->eTurn == PlayerTwo && stGame->Field[uiI+j][uiJ].eData != PlayerTwo){
+            return false;
+        } else if (stGame->eTurn == PlayerThree && stGame->Field[uiI-j][uiJ].eData != PlayerThree){
+            return false;
+        } else if (stGame->eTurn == PlayerFour && stGame->Field[uiI][uiJ+j].eData != PlayerFour){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned short GetDistToHomePos(tStGame *stGame, tStPosition stOldPos)
+{
+    tStPosition stNewPos = MovePawn(stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, 8*stGame->uiFieldWidth / 2); // 8 * 5 is maximum amount of steps possible
+    return 8*stGame->uiFieldWidth / 2 - stNewPos.uiMovesLeft;
+}
+
+tStPosition GetHomeSlot(tStGame *stGame, tEnumPlayer ePlayer, unsigned short uiSlot)
+{
+    tStPosition stPos = {-1, -1, 0};
+
+    // Home slots are counted from the home entry, the same way SetPlayerInHome walks into them
+    if (ePlayer == PlayerOne){
+        stPos.uiRowIndex = stGame->uiFieldHeight/2; stPos.uiColIndex = uiSlot;
+    } else if (ePlayer == PlayerTwo){
+        stPos.uiRowIndex = stGame->uiFieldHeight-1-uiSlot; stPos.uiColIndex = stGame->uiFieldWidth/2;
+    } else if (ePlayer == PlayerThree){
+        stPos.uiRowIndex = uiSlot; stPos.uiColIndex = stGame->uiFieldWidth/2;
+    } else if (ePlayer == PlayerFour){
+        stPos.uiRowIndex = stGame->uiFieldHeight/2; stPos.uiColIndex = stGame->uiFieldWidth-1-uiSlot;
+    }
+
+    return stPos;
+}
+
+bool GetRacePos(tStGame *stGame, tEnumPlayer ePlayer, tStRacePos *pstPos, tStPosition *astPawns)
+{
+    tEnumPlayer eTurn = stGame->eTurn;
+    bool xCovered = true;
+
+    if (CheckStartPos(stGame, ePlayer, false).uiColIndex <= stGame->uiFieldWidth){ // Pawns in the start area are not part of the race
+        return false;
+    }
+
+    pstPos->uiNrOfPawns = 0;
+    pstPos->uiHomeMask = 0;
+    stGame->eTurn = ePlayer; // GetDistToHomePos walks towards the home entry of the player in turn
+
+    for (int i=0; i<stGame->uiFieldHeight && xCovered; i++){
+        for (int j=0; j<stGame->uiFieldWidth && xCovered; j++){
+            tStPosition stPawn = ChoosePawn(stGame, i, j);
+            if (stPawn.uiColIndex <= stGame->uiFieldWidth){
+                if (pstPos->uiNrOfPawns == RACE_MAX_PAWNS){
+                    xCovered = false;
+                } else{
+                    astPawns[pstPos->uiNrOfPawns] = stPawn;
+                    pstPos->auiDist[pstPos->uiNrOfPawns] = GetDistToHomePos(stGame, stPawn);
+                    pstPos->uiNrOfPawns++;
+                }
+            }
+        }
+    }
+    stGame->eTurn = eTurn;
+
+    for (int k=1; k<5; k++){ // Amount of home positions
+        tStPosition stSlot = GetHomeSlot(stGame, ePlayer, k);
+        if (stGame->Field[stSlot.uiRowIndex][stSlot.uiColIndex].eData == ePlayer){
+            pstPos->uiHomeMask |= 1 << (k-1);
+        }
+    }
+
+    return xCovered && RaceTableCovers(pstPos);
+}
+
+tStPosition PickPawnRace(tStGame *stGame, unsigned short uiDice)
+{
+    tStPosition stBestPos = {-1, -1, 0};
+    tStPosition astPawns[RACE_MAX_PAWNS];
+    tStPosition astOther[RACE_MAX_PAWNS];
+    tStRacePos stOwn;
+    tStRacePos stRival;
+    tStRacePos stOther;
+    bool xRival = false;
+    float rBest = -9999;
+
+    if (!GetRacePos(stGame, stGame->eTurn, &stOwn, astPawns)){
+        return stBestPos;
+    }
+
+    // Race against the opponent that is closest to winning, if that opponent is in the race table as well
+    for (tEnumPlayer ePlayer=PlayerOne; ePlayer<=PlayerFour; ePlayer+=POFF){
+        if (ePlayer != stGame->eTurn && GetRacePos(stGame, ePlayer, &stOther, astOther)){
+            if (!xRival || RaceExpectedTurns(&stOther) < RaceExpectedTurns(&stRival)){
+                stRival = stOther;
+                xRival = true;
+            }
+        }
+    }
+
+    for (int i=0; i<stOwn.uiNrOfPawns; i++){
+        tStRacePos stNext;
+        if (RaceMove(&stOwn, i, uiDice, &stNext)){
+            float rScore = -RaceExpectedTurns(&stNext);
+            if (xRival){ // Throwing 6 gives another throw, otherwise the rival moves next
+                rScore = uiDice == 6 ? RaceWinChance(&stNext, &stRival) : 1 - RaceWinChance(&stRival, &stNext);
+            }
+            if (rScore > rBest){
+                rBest = rScore;
+                stBestPos = astPawns[i];
+            }
+        }
+    }
+
+    return stBestPos;
+}
+
+tStPosition PickPawnComputer(tStGame *stGame, unsigned short uiDice)
+{
+    tStPosition astPos[4];
+    tStPosition stBestPos = {-1, -1, 0};
+    unsigned short n = 0;
+    unsigned short uiDist = 9999;
+
+    // Near the end of the game use the race table instead of the greedy distance rule
+    stBestPos = PickPawnRace(stGame, uiDice);
+    if (stBestPos.uiColIndex <= stGame->uiFieldWidth){
+        return stBestPos;
+    }
+
+    // Get all the pawns that are on the board
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            if (((i>3 && i<7) || (j>3 && j<7)) && stGame->Field[i][j].eData == stGame->eTurn){
+                if (j != stGame->uiFieldWidth/2 && i != stGame->uiFieldHeight/2){ // Exclude (home positions) out of check
+                    astPos[n].uiRowIndex = i; astPos[n].uiColIndex = j;
+                    n++;
+                } else if ((i == stGame->uiFieldHeight/2 && (j == 0 || j == stGame->uiFieldWidth-1)) || (j == stGame->uiFieldWidth/2 && (i == 0 || i == stGame->uiFieldHeight-1))){ // The edges of the excluded area hold valid pawn locations
+                    astPos[n].uiRowIndex = i; astPos[n].uiColIndex = j;
+                    n++;
+                }
+            }
+        }
+    }
+
+    // Find out what pawn has to walk the shortest distance to the home pos
+    unsigned short k[4] = {99, 99, 99, 99};
+    for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
+        k[i] = GetDistToHomePos(stGame, astPos[i]);
+        if(k[i] < uiDist){
+            uiDist = k[i];
+            stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
+        }
+    }
+
+    // If computer is able to hit pawn which is not his own, hit that pawn OR If pawn cannot enter the home pos because of incorrect pips choose other pawn to move
+    for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
+        tStPosition stTemp = MovePawn(stGame, astPos[i].uiRowIndex, astPos[i].uiColIndex, uiDice);
+        if(stGame->Field[stTemp.uiRowIndex][stTemp.uiColIndex].eData % POFF == 0 && stTemp.uiMovesLeft == 0){ // Modulus of POFF means it hit one of the four players){
+            if(stGame->Field[stTemp.uiRowIndex][stTemp.uiColIndex].eData != stGame->eTurn){
+                stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
+            }
+        } else{
+            tStPosition stTemp2 = SetPlayerInHome(stGame, stTemp);
+            if (stTemp2.uiMovesLeft != 0){ // Pawn cannot enter home pos find second closest pawn to home pos
+                unsigned short uiTemp1 = 9999;
+                unsigned short uiTemp2 = 9999;
+                for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
+                    if(k[i] <= uiTemp1){
+                        uiTemp2 = uiTemp1;
+                        uiTemp1 = k[i];
+                    } else if(k[i] <= uiTemp2){
+                        uiTemp2 = k[i];
+                    }
+                }
+                for (int i=0; i<GetNumberOfSummonedPawns(stGame); i++){
+                    if(k[i] == uiTemp2){
+                        stBestPos.uiRowIndex = astPos[i].uiRowIndex; stBestPos.uiColIndex = astPos[i].uiColIndex;
+                    }
+                }
+            }
+        }
+    }
+
+    return stBestPos;
+}
+
+bool IsMoveLegal(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice)
+{
+    tStPosition stNewPos = MovePawn(stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, uiDice);
+    return SetPlayerInHome(stGame, stNewPos).uiMovesLeft == 0;
+}
+
+// Fails without touching the board when a position is off the board or the start area of the hitted player is full
+static bool DoMove(tStGame *stGame, tStPosition stOldPos, tStPosition stNewPos, tStMove *pstMove)
+{
+    if (stOldPos.uiRowIndex >= stGame->uiFieldHeight || stOldPos.uiColIndex >= stGame->uiFieldWidth || stNewPos.uiRowIndex >= stGame->uiFieldHeight || stNewPos.uiColIndex >= stGame->uiFieldWidth){
+        return false;
+    }
+
+    pstMove->stFrom = stOldPos;
+    pstMove->stTo = stNewPos;
+    pstMove->eHit = stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData;
+    pstMove->eTurn = stGame->eTurn;
+    pstMove->stYard.uiRowIndex = -1; pstMove->stYard.uiColIndex = -1;
+
+    if (pstMove->eHit % POFF == 0 && pstMove->eHit != NoPosition){ // Remember where the hitted player is placed back
+        pstMove->stYard = CheckStartPos(stGame, pstMove->eHit, true);
+        if (pstMove->stYard.uiColIndex >= stGame->uiFieldWidth){
+            return false;
+        }
+        stGame->Field[pstMove->stYard.uiRowIndex][pstMove->stYard.uiColIndex].eData = pstMove->eHit;
+    }
+
+    stGame->Field[stOldPos.uiRowIndex][stOldPos.uiColIndex].eData = Empty; // Remove old traces of the current player
+    stGame->Field[stNewPos.uiRowIndex][stNewPos.uiColIndex].eData = stGame->eTurn; // Set current player to the new pos
+    return true;
+}
+
+bool MakeMove(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice, tStMove *pstMove)
+{
+    if (stOldPos.uiRowIndex >= stGame->uiFieldHeight || stOldPos.uiColIndex >= stGame->uiFieldWidth){ // No pawn was found
+        return false;
+    }
+
+    tStPosition stNewPos = MovePawn(stGame, stOldPos.uiRowIndex, stOldPos.uiColIndex, uiDice);
+
+    if (stNewPos.uiMovesLeft != 0){
+        stNewPos = SetPlayerInHome(stGame, stNewPos);
+        if (stNewPos.uiMovesLeft != 0){ // Move is impossible do not move player
+            return false;
+        }
+    }
+
+    return DoMove(stGame, stOldPos, stNewPos, pstMove);
+}
+
+void UnmakeMove(tStGame *stGame, const tStMove *pstMove)
+{
+    if (pstMove->stYard.uiColIndex <= stGame->uiFieldWidth){
+        stGame->Field[pstMove->stYard.uiRowIndex][pstMove->stYard.uiColIndex].eData = Empty;
+    }
+
+    stGame->Field[pstMove->stTo.uiRowIndex][pstMove->stTo.uiColIndex].eData = pstMove->eHit;
+    stGame->Field[pstMove->stFrom.uiRowIndex][pstMove->stFrom.uiColIndex].eData = pstMove->eTurn;
+    stGame->eTurn = pstMove->eTurn;
+}
+
+bool ApplyMove(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice)
+{
+    tStMove stMove;
+    return MakeMove(stGame, stOldPos, uiDice, &stMove);
+}
+
+bool SummonFromStart(tStGame *stGame, tStMove *pstMove)
+{
+    return DoMove(stGame, CheckStartPos(stGame, stGame->eTurn, false), SummonPawn(stGame), pstMove); // Fails when no pawn is left in the start area
+}
+
+static unsigned char GetPawnOrdinal(tStGame *stGame, tStPosition stPos)
+{
+    unsigned char uiOrdinal = 0;
+
+    // Own pawns in front of stPos when the board is read row by row
+    for (int k=0; k<stPos.uiRowIndex*FIELD_SIZE+stPos.uiColIndex; k++){
+        uiOrdinal += stGame->Field[k/FIELD_SIZE][k%FIELD_SIZE].eData == stGame->eTurn;
+    }
+
+    return uiOrdinal;
+}
+
+tStPosition GetPawnByOrdinal(tStGame *stGame, unsigned short uiOrdinal)
+{
+    tStPosition stPos = {-1, -1, 0};
+
+    for (int k=0; k<FIELD_SIZE*FIELD_SIZE; k++){
+        if (stGame->Field[k/FIELD_SIZE][k%FIELD_SIZE].eData == stGame->eTurn && uiOrdinal-- == 0){
+            stPos.uiRowIndex = k/FIELD_SIZE; stPos.uiColIndex = k%FIELD_SIZE;
+            break;
+        }
+    }
+
+    return stPos;
+}
+
+static void LogThrow(tStTurnLog *pstLog, unsigned short uiDice, unsigned char uiMove)
+{
+    if (pstLog != NULL){
+        if (pstLog->uiThrows < TURN_LOG_SIZE){
+            pstLog->auiDice[pstLog->uiThrows] = uiDice;
+            pstLog->auiMove[pstLog->uiThrows] = uiMove;
+        }
+        pstLog->uiThrows++;
+    }
+}
+
+bool PlayTurnLogged(tStGame *stGame, tPickPawn pfPick, tStTurnLog *pstLog)
+{
+    // Headless version of the turn flow in main(), without waiting for input or animations
+    unsigned short uiNrOfMaxPips = 0;
+    unsigned short uiDice;
+
+    if (pstLog != NULL){
+        pstLog->uiThrows = 0;
+    }
+
+    do{
+        uiDice = RollDice(stGame);
+        tStPosition stStart = SummonPawn(stGame);
+        tStPosition stOldPos;
+        tStMove stMove;
+
+        if (uiDice == 6 && uiNrOfMaxPips%2 == 0 && CheckStartPos(stGame, stGame->eTurn, false).uiColIndex <= stGame->uiFieldWidth){
+            SummonFromStart(stGame, &stMove);
+            LogThrow(pstLog, uiDice, MOVE_SUMMON);
+            uiNrOfMaxPips++;
+        } else{
+            if (uiNrOfMaxPips%2 == 1 && stGame->Field[stStart.uiRowIndex][stStart.uiColIndex].eData == stGame->eTurn){ // Force player to move the summoned pawn
+                stOldPos = stStart;
+            } else if (GetNumberOfSummonedPawns(stGame) == 0){
+                LogThrow(pstLog, uiDice, MOVE_END);
+                return false;
+            } else{
+                stOldPos = pfPick(stGame, uiDice);
+            }
+
+            uiNrOfMaxPips++;
+            unsigned char uiMove = stOldPos.uiColIndex <= stGame->uiFieldWidth ? GetPawnOrdinal(stGame, stOldPos) : MOVE_NONE;
+            if (uiMove == MOVE_NONE || !ApplyMove(stGame, stOldPos, uiDice)){
+                uiMove = MOVE_NONE;
+            }
+            LogThrow(pstLog, uiDice, uiMove);
+        }
+
+        if (CheckWinner(stGame)){
+            return true;
+        }
+    } while (uiDice == 6);
+
+    return false;
+}
+
+bool PlayTurn(tStGame *stGame, tPickPawn pfPick)
+{
+    return PlayTurnLogged(stGame, pfPick, NULL);
+}
+
+tEnumReplay ReplayThrow(tStGame *stGame, unsigned short uiDice, unsigned char uiMove)
+{
+    tStMove stMove;
+
+    // A logged move is always possible on the board of the player who logged it, a move that is not comes from another board
+    if (uiMove == MOVE_SUMMON && !SummonFromStart(stGame, &stMove)){
+        return ReplayInvalid;
+    } else if (uiMove < MOVE_SUMMON && !ApplyMove(stGame, GetPawnByOrdinal(stGame, uiMove), uiDice)){
+        return ReplayInvalid;
+    } else if (uiMove > MOVE_END){
+        return ReplayInvalid;
+    }
+
+    return uiMove == MOVE_END || uiDice != 6 || CheckWinner(stGame) ? ReplayTurnOver : ReplayNext;
+}
+
+unsigned long long HashBoard(tStGame *stGame)
+{
+    unsigned long long ulHash = 14695981039346656037ULL; // 64 bit FNV-1a
+
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            ulHash = (ulHash ^ (unsigned char)stGame->Field[i][j].eData) * 1099511628211ULL;
+        }
+    }
+
+    return (ulHash ^ stGame->eTurn) * 1099511628211ULL;
+}
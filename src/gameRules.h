@@ -0,0 +1,131 @@
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+#include <stdbool.h>
+#include "raceTable.h"
+#include "memTrack.h"
+
+#define WIDTH 960 // Screen width
+#define HEIGHT 544 // Screen height
+#define POFF 10 // Player number offset (Ex: POFF == 10, P1 = 10, P2 = 20)
+#define FIELD_SIZE 11 // Board is FIELD_SIZE x FIELD_SIZE fields
+
+typedef enum tEnumPlayer{
+    NoPosition,
+	Empty,
+	PlayerOne = 1*POFF,
+    PlayerOneHome,
+    PlayerOneStart,
+	PlayerTwo = 2*POFF,
+	PlayerTwoHome,
+    PlayerTwoStart,
+    PlayerThree = 3*POFF,
+    PlayerThreeHome,
+    PlayerThreeStart,
+    PlayerFour = 4*POFF,
+    PlayerFourHome,
+    PlayerFourStart
+} tEnumPlayer;
+
+typedef struct tStBoard
+{
+	unsigned short uiX;
+	unsigned short uiY;
+	tEnumPlayer eData;
+} tStBoard;
+
+typedef struct tStGame
+{
+	tStBoard **Field;
+	tEnumPlayer eTurn;
+	unsigned short uiCellWidth;
+	unsigned short uiCellHeight;
+	unsigned short uiFieldWidth;
+	unsigned short uiFieldHeight;
+	unsigned int uiSeed; // State of the dice generator
+} tStGame;
+
+typedef struct tStPosition
+{
+    unsigned short uiRowIndex;
+    unsigned short uiColIndex;
+    unsigned short uiMovesLeft;
+} tStPosition;
+
+typedef struct tStMove
+{
+    tStPosition stFrom;
+    tStPosition stTo;
+    tStPosition stYard; // Start area field the hitted player was placed back on, -1 when nothing was hit
+    tEnumPlayer eHit; // Previous content of stTo
+    tEnumPlayer eTurn;
+} tStMove;
+
+typedef struct tStSnapshot
+{
+    unsigned char auiData[FIELD_SIZE*FIELD_SIZE];
+    tEnumPlayer eTurn;
+} tStSnapshot;
+
+#define TURN_LOG_SIZE 32 // Throws kept per turn, more only happens after 31 sixes in a row
+#define MOVE_SUMMON 4 // Move codes besides the ordinal 0-3 of the moved pawn
+#define MOVE_NONE 5
+#define MOVE_END 6 // Nothing to move, the turn ends even after a 6
+
+typedef struct tStTurnLog
+{
+    unsigned short uiThrows; // Can exceed TURN_LOG_SIZE, only the first throws are kept
+    unsigned char auiDice[TURN_LOG_SIZE];
+    unsigned char auiMove[TURN_LOG_SIZE]; // Ordinal of the moved pawn in reading order of the board or one of the MOVE_ codes
+} tStTurnLog;
+
+typedef enum tEnumReplay
+{
+    ReplayNext, // The player throws again
+    ReplayTurnOver,
+    ReplayInvalid // The move is not possible on this board, nothing was changed
+} tEnumReplay;
+
+typedef tStPosition (*tPickPawn)(tStGame *stGame, unsigned short uiDice);
+typedef unsigned long long (*tGetTimeUs)();
+
+void BoardConstructor(tStGame *stGame);
+void BoardConstructorTagged(tStGame *stGame, tEnumMemTag eTag);
+void BoardDestructor(tStGame *stGame);
+void SaveSnapshot(tStGame *stGame, tStSnapshot *pstSnapshot);
+void LoadSnapshot(tStGame *stGame, const tStSnapshot *pstSnapshot);
+void CreatePlayers(tStGame *stGame);
+void CreatePlayingCircle(tStGame *stGame);
+void CreateHomePositions(tStGame *stGame);
+void CreateStartPositions(tStGame *stGame);
+void BoardInitializer(tStGame *stGame);
+void SeedDice(tStGame *stGame, unsigned int uiSeed);
+unsigned short RollDice(tStGame *stGame);
+tStPosition ChoosePawn(tStGame *stGame, unsigned short i, unsigned short j);
+tStPosition GetClosestField(tStGame *stGame, unsigned short uiX, unsigned short uiY);
+tStPosition MovePawn(tStGame *stGame, unsigned short i, unsigned short j, unsigned short uiMoves);
+tStPosition CheckStartPos(tStGame *stGame, tEnumPlayer ePlayer, bool xFindEmptySpot);
+void RemovePlayer(tStGame *stGame, tStPosition stNewPos);
+tStPosition CheckHit(tStGame *stGame, tStPosition stNewPos, tStPosition stOldPos);
+void SwitchPlayer(tStGame *stGame);
+tStPosition SummonPawn(tStGame *stGame);
+unsigned short GetNumberOfSummonedPawns(tStGame *stGame);
+tStPosition SetPlayerInHome(tStGame *stGame, tStPosition stNewPos);
+bool CheckWinner(tStGame *stGame);
+unsigned short GetDistToHomePos(tStGame *stGame, tStPosition stOldPos);
+tStPosition GetHomeSlot(tStGame *stGame, tEnumPlayer ePlayer, unsigned short uiSlot);
+bool GetRacePos(tStGame *stGame, tEnumPlayer ePlayer, tStRacePos *pstPos, tStPosition *astPawns);
+tStPosition PickPawnRace(tStGame *stGame, unsigned short uiDice);
+tStPosition PickPawnComputer(tStGame *stGame, unsigned short uiDice);
+bool IsMoveLegal(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice);
+bool MakeMove(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice, tStMove *pstMove);
+void UnmakeMove(tStGame *stGame, const tStMove *pstMove);
+bool ApplyMove(tStGame *stGame, tStPosition stOldPos, unsigned short uiDice);
+bool SummonFromStart(tStGame *stGame, tStMove *pstMove);
+bool PlayTurn(tStGame *stGame, tPickPawn pfPick);
+bool PlayTurnLogged(tStGame *stGame, tPickPawn pfPick, tStTurnLog *pstLog);
+tStPosition GetPawnByOrdinal(tStGame *stGame, unsigned short uiOrdinal);
+tEnumReplay ReplayThrow(tStGame *stGame, unsigned short uiDice, unsigned char uiMove);
+unsigned long long HashBoard(tStGame *stGame);
+
+#endif
@@ -0,0 +1,46 @@
+#include "history.h"
+
+void HistoryReset(tStHistory *stHistory)
+{
+    stHistory->uiFirst = 0;
+    stHistory->uiCount = 0;
+    stHistory->uiCursor = 0;
+}
+
+void HistoryPush(tStHistory *stHistory, tStGame *stGame)
+{
+    if (stHistory->uiCount > 0){
+        stHistory->uiCount = stHistory->uiCursor + 1; // A new turn drops the turns that could be redone
+    }
+
+    if (stHistory->uiCount == HISTORY_SIZE){ // Ring is full, forget the oldest turn
+        stHistory->uiFirst = (stHistory->uiFirst + 1) % HISTORY_SIZE;
+        stHistory->uiCount--;
+    }
+
+    SaveSnapshot(stGame, &stHistory->astRing[(stHistory->uiFirst + stHistory->uiCount) % HISTORY_SIZE]);
+    stHistory->uiCursor = stHistory->uiCount;
+    stHistory->uiCount++;
+}
+
+bool HistoryUndo(tStHistory *stHistory, tStGame *stGame)
+{
+    if (stHistory->uiCursor == 0){
+        return false;
+    }
+
+    stHistory->uiCursor--;
+    LoadSnapshot(stGame, &stHistory->astRing[(stHistory->uiFirst + stHistory->uiCursor) % HISTORY_SIZE]);
+    return true;
+}
+
+bool HistoryRedo(tStHistory *stHistory, tStGame *stGame)
+{
+    if (stHistory->uiCursor + 1 >= stHistory->uiCount){
+        return false;
+    }
+
+    stHistory->uiCursor++;
+    LoadSnapshot(stGame, &stHistory->astRing[(stHistory->uiFirst + stHistory->uiCursor) % HISTORY_SIZE]);
+    return true;
+}
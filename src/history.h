@@ -0,0 +1,21 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "gameRules.h"
+
+#define HISTORY_SIZE 64 // Amount of turns that can be taken back
+
+typedef struct tStHistory
+{
+    tStSnapshot astRing[HISTORY_SIZE];
+    unsigned short uiFirst; // Oldest snapshot in the ring
+    unsigned short uiCount; // Snapshots that can be redone up to
+    unsigned short uiCursor; // Snapshot the board currently shows, counted from uiFirst
+} tStHistory;
+
+void HistoryReset(tStHistory *stHistory);
+void HistoryPush(tStHistory *stHistory, tStGame *stGame);
+bool HistoryUndo(tStHistory *stHistory, tStGame *stGame);
+bool HistoryRedo(tStHistory *stHistory, tStGame *stGame);
+
+#endif
@@ -0,0 +1,287 @@
+#include <string.h>
+#include "lockstep.h"
+
+#define LOCK_TURN_SIZE (LOCK_HEADER + 9) // Without the throws, one byte each
+#define LOCK_STATE_SIZE (LOCK_HEADER + 6 + FIELD_SIZE*FIELD_SIZE)
+
+// Smallest size of every tEnumLockMsg, shorter messages are dropped before they are read
+static const unsigned short auiMinSize[LockState+1] = {LOCK_HEADER, LOCK_HEADER+4, LOCK_TURN_SIZE, LOCK_HEADER, LOCK_STATE_SIZE};
+
+static void PutHeader(tStLockPeer *pstPeer, unsigned char *pcMsg, tEnumLockMsg eType, unsigned short uiSize)
+{
+    unsigned long long ulNow = pstPeer->pfNow();
+
+    pcMsg[0] = eType;
+    pcMsg[1] = pstPeer->uiPeer;
+    memcpy(&pcMsg[2], &uiSize, 2);
+    memcpy(&pcMsg[4], &pstPeer->uiTurn, 4);
+    memcpy(&pcMsg[8], &ulNow, 8); // Only used to measure the latency, peers on different devices do not share a clock
+}
+
+static void Send(tStLockPeer *pstPeer, const unsigned char *pcMsg, unsigned short uiSize)
+{
+    pstPeer->stStats.uiBytesSent += pstPeer->stLink.pfSend(pstPeer->stLink.pvCtx, pcMsg, uiSize);
+    pstPeer->stStats.uiMessagesSent++;
+}
+
+static void SendState(tStLockPeer *pstPeer, unsigned char uiTo)
+{
+    unsigned char acMsg[LOCK_STATE_SIZE];
+    tStSnapshot stSnapshot;
+
+    SaveSnapshot(pstPeer->stGame, &stSnapshot);
+    PutHeader(pstPeer, acMsg, LockState, LOCK_STATE_SIZE);
+    memcpy(&acMsg[LOCK_HEADER], &pstPeer->stGame->uiSeed, 4);
+    acMsg[LOCK_HEADER+4] = pstPeer->stGame->eTurn/POFF;
+    acMsg[LOCK_HEADER+5] = uiTo;
+    memcpy(&acMsg[LOCK_HEADER+6], stSnapshot.auiData, FIELD_SIZE*FIELD_SIZE);
+    Send(pstPeer, acMsg, LOCK_STATE_SIZE);
+}
+
+static void RequestResync(tStLockPeer *pstPeer)
+{
+    unsigned char acMsg[LOCK_HEADER];
+
+    PutHeader(pstPeer, acMsg, LockResync, LOCK_HEADER);
+    Send(pstPeer, acMsg, LOCK_HEADER);
+    pstPeer->xAwaitingState = true;
+    pstPeer->ulWaitSince = pstPeer->pfNow();
+}
+
+static void LoadState(tStLockPeer *pstPeer, const unsigned char *pcMsg)
+{
+    tStSnapshot stSnapshot;
+
+    memcpy(&pstPeer->stGame->uiSeed, &pcMsg[LOCK_HEADER], 4);
+    stSnapshot.eTurn = pcMsg[LOCK_HEADER+4]*POFF;
+    memcpy(stSnapshot.auiData, &pcMsg[LOCK_HEADER+6], FIELD_SIZE*FIELD_SIZE);
+    LoadSnapshot(pstPeer->stGame, &stSnapshot);
+    memcpy(&pstPeer->uiTurn, &pcMsg[4], 4);
+    memset(pstPeer->auiPendingSize, 0, sizeof(pstPeer->auiPendingSize)); // Turns held back may follow a dropped turn
+
+    pstPeer->xStarted = true; // Also recovers a lost LockStart
+    pstPeer->xAwaitingState = false;
+    pstPeer->ulWaitSince = pstPeer->pfNow();
+    pstPeer->xFinished = CheckWinner(pstPeer->stGame);
+    pstPeer->stStats.uiResyncs++;
+    pstPeer->stStats.ulResyncTime = pstPeer->pfNow();
+}
+
+void LockstepInit(tStLockPeer *pstPeer, tStGame *stGame, unsigned char uiPeer, unsigned char uiSeats, tStTransport stLink, tGetTimeUs pfNow)
+{
+    memset(pstPeer, 0, sizeof(tStLockPeer));
+    pstPeer->stGame = stGame;
+    pstPeer->uiPeer = uiPeer;
+    pstPeer->uiSeats = uiSeats;
+    pstPeer->stLink = stLink;
+    pstPeer->pfNow = pfNow;
+    pstPeer->ulTimeoutUs = LOCK_TIMEOUT_US;
+}
+
+static void StartGame(tStLockPeer *pstPeer, unsigned int uiSeed)
+{
+    BoardInitializer(pstPeer->stGame);
+    pstPeer->stGame->eTurn = PlayerOne;
+    SeedDice(pstPeer->stGame, uiSeed);
+    pstPeer->uiTurn = 0;
+    pstPeer->xStarted = true;
+    pstPeer->xFinished = false;
+    pstPeer->xAwaitingState = false;
+    pstPeer->ulWaitSince = pstPeer->pfNow();
+    memset(pstPeer->auiPendingSize, 0, sizeof(pstPeer->auiPendingSize));
+}
+
+void LockstepStart(tStLockPeer *pstPeer, unsigned int uiSeed)
+{
+    unsigned char acMsg[LOCK_HEADER+4];
+
+    StartGame(pstPeer, uiSeed);
+    PutHeader(pstPeer, acMsg, LockStart, LOCK_HEADER+4);
+    memcpy(&acMsg[LOCK_HEADER], &uiSeed, 4);
+    Send(pstPeer, acMsg, LOCK_HEADER+4);
+}
+
+static void Receive(tStLockPeer *pstPeer)
+{
+    unsigned char acMsg[LOCK_MAX_MSG];
+    unsigned int uiSize;
+
+    while ((uiSize = pstPeer->stLink.pfReceive(pstPeer->stLink.pvCtx, acMsg, LOCK_MAX_MSG)) > 0){
+        unsigned int uiTurn;
+        unsigned int uiSeed;
+        pstPeer->stStats.uiBytesReceived += uiSize;
+
+        // Unknown types are skipped by the switch, a known type has to carry all of its fields
+        if (uiSize < LOCK_HEADER || uiSize > LOCK_MAX_MSG || (acMsg[0] <= LockState && uiSize < auiMinSize[acMsg[0]])){
+            pstPeer->stStats.uiRejected++;
+            continue;
+        }
+        memcpy(&uiTurn, &acMsg[4], 4);
+
+        switch (acMsg[0]){
+
+        case LockStart:
+            if (acMsg[1] == LOCK_AUTHORITY){
+                memcpy(&uiSeed, &acMsg[LOCK_HEADER], 4);
+                StartGame(pstPeer, uiSeed);
+            }
+            break;
+
+        case LockTurn:
+            if (uiTurn >= pstPeer->uiTurn && uiTurn < pstPeer->uiTurn + LOCK_PENDING){ // Older turns are already covered by a state
+                memcpy(pstPeer->aauiPending[uiTurn % LOCK_PENDING], acMsg, uiSize);
+                pstPeer->auiPendingSize[uiTurn % LOCK_PENDING] = uiSize;
+            }
+            break;
+
+        case LockResync:
+            if (pstPeer->uiPeer == LOCK_AUTHORITY && pstPeer->xStarted){
+                SendState(pstPeer, acMsg[1]);
+            }
+            break;
+
+        case LockState:
+            // Late answers to a repeated request are dropped, they could take the peer back
+            if (acMsg[1] == LOCK_AUTHORITY && pstPeer->uiPeer != LOCK_AUTHORITY && (acMsg[LOCK_HEADER+5] == LOCK_ALL || (acMsg[LOCK_HEADER+5] == pstPeer->uiPeer && pstPeer->xAwaitingState))){
+                LoadState(pstPeer, acMsg);
+            }
+            break;
+
+        default :
+            break;
+        }
+    }
+}
+
+static void PlayLocalTurn(tStLockPeer *pstPeer, tPickPawn pfPick)
+{
+    unsigned char acMsg[LOCK_TURN_SIZE + TURN_LOG_SIZE];
+    tStTurnLog stLog;
+    bool xWon = PlayTurnLogged(pstPeer->stGame, pfPick, &stLog);
+    unsigned long long ulHash = HashBoard(pstPeer->stGame);
+    unsigned short uiThrows = stLog.uiThrows < TURN_LOG_SIZE ? stLog.uiThrows : TURN_LOG_SIZE; // Longer turns need 31 sixes in a row and show up as a desync
+    unsigned short uiSize = LOCK_TURN_SIZE + uiThrows;
+
+    PutHeader(pstPeer, acMsg, LockTurn, uiSize);
+    memcpy(&acMsg[LOCK_HEADER], &ulHash, 8);
+    acMsg[LOCK_HEADER+8] = uiThrows;
+    for (int k=0; k<uiThrows; k++){
+        acMsg[LOCK_HEADER+9+k] = stLog.auiDice[k] << 3 | stLog.auiMove[k];
+    }
+    Send(pstPeer, acMsg, uiSize);
+
+    pstPeer->stStats.uiLocalTurns++;
+    pstPeer->uiTurn++;
+    pstPeer->ulWaitSince = pstPeer->pfNow();
+    pstPeer->xFinished = xWon;
+    if (!xWon){
+        SwitchPlayer(pstPeer->stGame);
+    }
+}
+
+static void ApplyRemoteTurn(tStLockPeer *pstPeer)
+{
+    unsigned char *pcMsg = pstPeer->aauiPending[pstPeer->uiTurn % LOCK_PENDING];
+    unsigned int uiSize = pstPeer->auiPendingSize[pstPeer->uiTurn % LOCK_PENDING];
+    unsigned int uiThrows = pcMsg[LOCK_HEADER+8];
+    unsigned long long ulHash;
+    unsigned long long ulSent;
+    unsigned int uiSeed = pstPeer->stGame->uiSeed;
+    tStSnapshot stBefore;
+    bool xDesync = false;
+
+    memcpy(&ulHash, &pcMsg[LOCK_HEADER], 8);
+    memcpy(&ulSent, &pcMsg[8], 8);
+    pstPeer->auiPendingSize[pstPeer->uiTurn % LOCK_PENDING] = 0;
+    uiThrows = uiThrows < TURN_LOG_SIZE ? uiThrows : TURN_LOG_SIZE; // A clipped turn does not match the hash and ends in a desync
+    uiThrows = uiThrows < uiSize - LOCK_TURN_SIZE ? uiThrows : uiSize - LOCK_TURN_SIZE;
+    SaveSnapshot(pstPeer->stGame, &stBefore);
+
+    // Roll the same dice as the sender, a different value means the dice seed already went apart and a move
+    // that is not possible here means the boards did, both stop the replay before the throw is applied
+    for (unsigned int k=0; k<uiThrows && !xDesync; k++){
+        unsigned short uiDice = RollDice(pstPeer->stGame);
+        xDesync = uiDice != pcMsg[LOCK_HEADER+9+k] >> 3 || ReplayThrow(pstPeer->stGame, uiDice, pcMsg[LOCK_HEADER+9+k] & 7) == ReplayInvalid;
+    }
+
+    if (xDesync || HashBoard(pstPeer->stGame) != ulHash){
+        pstPeer->stStats.uiDesyncs++;
+        pstPeer->stStats.uiDesyncTurn = pstPeer->uiTurn;
+        pstPeer->stStats.ulDesyncTime = pstPeer->pfNow();
+        LoadSnapshot(pstPeer->stGame, &stBefore); // Nothing of the turn stays on the board until the state of the authority settles it
+        pstPeer->stGame->uiSeed = uiSeed;
+        if (pstPeer->uiPeer == LOCK_AUTHORITY){ // The sender went apart, drop its turn and make every peer load the board before it
+            memset(pstPeer->auiPendingSize, 0, sizeof(pstPeer->auiPendingSize));
+            SendState(pstPeer, LOCK_ALL);
+            pstPeer->ulWaitSince = pstPeer->pfNow();
+            pstPeer->stStats.uiResyncs++;
+            pstPeer->stStats.ulResyncTime = pstPeer->ulWaitSince;
+        } else{
+            RequestResync(pstPeer);
+        }
+        return;
+    }
+
+    unsigned long long ulLatency = pstPeer->pfNow() - ulSent;
+    pstPeer->stStats.ulApplyUs += ulLatency;
+    pstPeer->stStats.ulMaxApplyUs = ulLatency > pstPeer->stStats.ulMaxApplyUs ? ulLatency : pstPeer->stStats.ulMaxApplyUs;
+    pstPeer->stStats.uiRemoteTurns++;
+    pstPeer->uiTurn++;
+    pstPeer->ulWaitSince = pstPeer->pfNow();
+    pstPeer->xFinished = CheckWinner(pstPeer->stGame);
+    if (!pstPeer->xFinished){
+        SwitchPlayer(pstPeer->stGame);
+    }
+}
+
+// Nothing arrived for too long, the authority sends its state to every peer, the others ask for it
+static void HandleTimeout(tStLockPeer *pstPeer)
+{
+    pstPeer->stStats.uiTimeouts++;
+    if (pstPeer->uiPeer == LOCK_AUTHORITY){
+        SendState(pstPeer, LOCK_ALL); // The owner of the missing turn loads it and plays the turn again
+        pstPeer->ulWaitSince = pstPeer->pfNow();
+    } else{
+        RequestResync(pstPeer);
+    }
+}
+
+bool LockstepStep(tStLockPeer *pstPeer, tPickPawn pfPick)
+{
+    Receive(pstPeer);
+
+    bool xTimeout = pstPeer->pfNow() - pstPeer->ulWaitSince > pstPeer->ulTimeoutUs;
+    if (pstPeer->ulWaitSince == 0){ // First step, the wait for LockStart begins now
+        pstPeer->ulWaitSince = pstPeer->pfNow();
+        xTimeout = false;
+    }
+
+    if (!pstPeer->xStarted){ // The authority answers once it has started, this covers a lost LockStart
+        if (xTimeout && pstPeer->uiPeer != LOCK_AUTHORITY){
+            HandleTimeout(pstPeer);
+        }
+        return false;
+    } else if (pstPeer->xFinished){
+        return true;
+    }
+
+    if (pstPeer->xAwaitingState){ // Wait for the state, ask again when it got lost
+        if (xTimeout){
+            HandleTimeout(pstPeer);
+        }
+        return false;
+    }
+
+    unsigned int uiPendingTurn;
+    memcpy(&uiPendingTurn, &pstPeer->aauiPending[pstPeer->uiTurn % LOCK_PENDING][4], 4);
+
+    if (pstPeer->uiSeats & (1 << (pstPeer->stGame->eTurn/POFF))){
+        PlayLocalTurn(pstPeer, pfPick);
+    } else if (pstPeer->auiPendingSize[pstPeer->uiTurn % LOCK_PENDING] > 0 && uiPendingTurn == pstPeer->uiTurn){
+        ApplyRemoteTurn(pstPeer);
+    } else if (xTimeout){ // The turn got lost on the way
+        HandleTimeout(pstPeer);
+    }
+
+    return pstPeer->xFinished;
+}
@@ -0,0 +1,74 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include "gameRules.h"
+
+// Peers share one game by sending only the dice seed and the pawn choices of every turn, the dice are
+// rolled on every peer from the same seed. The hash of the board after each turn detects a desync.
+// Peer 0 starts the game and is the only authority for its state: the other peers load the state of
+// peer 0 after a desync or when a message got lost, peer 0 drops a turn which does not match its own
+// board and makes every peer load its state, so the owner of the seat plays the turn again.
+#define LOCK_MAX_PEERS 4
+#define LOCK_AUTHORITY 0 // Peer which sends LockStart and the state
+#define LOCK_ALL 0xFF // State for every peer, sent by the authority after it dropped a turn
+#define LOCK_PENDING 8 // Turn messages which can arrive ahead of the turn that is applied next
+#define LOCK_MAX_MSG 160 // Largest message, a full state
+#define LOCK_HEADER 16 // Type, peer, size, turn and send time, the fields of the message type follow
+#define LOCK_TIMEOUT_US 100000 // Default wait for the next turn or a state, after it the state of the authority is fetched again
+
+typedef enum tEnumLockMsg
+{
+    LockStart = 1, // Dice seed for a new game, sent by peer 0
+    LockTurn, // Dice and moves of one turn and the hash after it
+    LockResync, // Request for the full state of the authority
+    LockState // Full state, dice seed, player on turn, receiver and board
+} tEnumLockMsg;
+
+typedef struct tStTransport
+{
+    void *pvCtx;
+    unsigned int (*pfSend)(void *pvCtx, const unsigned char *pcData, unsigned int uiSize); // Delivers to all other peers, returns the bytes put on the network
+    unsigned int (*pfReceive)(void *pvCtx, unsigned char *pcData, unsigned int uiSize); // Returns 0 when nothing is waiting
+} tStTransport;
+
+typedef struct tStLockStats
+{
+    unsigned int uiBytesSent; // As reported by the transport, one datagram per receiver counts for each of them
+    unsigned int uiBytesReceived;
+    unsigned int uiMessagesSent;
+    unsigned int uiRejected; // Received messages which are shorter than their type needs
+    unsigned int uiTimeouts; // Waits for a turn or a state that ran out
+    unsigned int uiLocalTurns;
+    unsigned int uiRemoteTurns;
+    unsigned long long ulApplyUs; // Time from sending a turn until it was applied here, summed over remote turns
+    unsigned long long ulMaxApplyUs;
+    unsigned int uiDesyncs;
+    unsigned int uiResyncs;
+    unsigned int uiDesyncTurn; // Turn at which the last desync was found
+    unsigned long long ulDesyncTime;
+    unsigned long long ulResyncTime;
+} tStLockStats;
+
+typedef struct tStLockPeer
+{
+    tStGame *stGame;
+    tStTransport stLink;
+    tGetTimeUs pfNow;
+    unsigned char uiPeer;
+    unsigned char uiSeats; // Bit p is set when player p*POFF plays on this peer
+    bool xStarted;
+    bool xFinished;
+    unsigned int uiTurn; // Turns applied so far
+    bool xAwaitingState; // A resync was requested and no state arrived yet
+    unsigned long long ulWaitSince; // Start of the wait for the next turn or the state
+    unsigned long long ulTimeoutUs; // LOCK_TIMEOUT_US unless the caller changes it after LockstepInit
+    unsigned char aauiPending[LOCK_PENDING][LOCK_MAX_MSG];
+    unsigned int auiPendingSize[LOCK_PENDING];
+    tStLockStats stStats;
+} tStLockPeer;
+
+void LockstepInit(tStLockPeer *pstPeer, tStGame *stGame, unsigned char uiPeer, unsigned char uiSeats, tStTransport stLink, tGetTimeUs pfNow);
+void LockstepStart(tStLockPeer *pstPeer, unsigned int uiSeed);
+bool LockstepStep(tStLockPeer *pstPeer, tPickPawn pfPick);
+
+#endif
@@ -0,0 +1,72 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "memTrack.h"
+
+typedef union tUnMemHeader // Keeps size and tag in front of every block, aligned like malloc
+{
+    struct
+    {
+        size_t uiSize;
+        tEnumMemTag eTag;
+    } stInfo;
+    long double rAlign;
+} tUnMemHeader;
+
+static tStMemStats stStats;
+static bool xLocked = false;
+
+void *MemAlloc(size_t uiSize, tEnumMemTag eTag)
+{
+#ifdef MEMTRACK_DEBUG
+    assert(!xLocked); // Memory has to be allocated before the frame loop starts
+#endif
+
+    tUnMemHeader *pHeader = malloc(sizeof(tUnMemHeader) + uiSize);
+    if (pHeader == NULL){
+        return NULL;
+    }
+    pHeader->stInfo.uiSize = uiSize;
+    pHeader->stInfo.eTag = eTag;
+
+    tStMemCounter *pstCounter = &stStats.astTag[eTag];
+    pstCounter->uiAllocs++;
+    pstCounter->uiBytes += uiSize;
+    pstCounter->uiPeakBytes = pstCounter->uiBytes > pstCounter->uiPeakBytes ? pstCounter->uiBytes : pstCounter->uiPeakBytes;
+    stStats.uiFrameAllocs++;
+    stStats.uiLockedAllocs += xLocked;
+
+    return pHeader + 1;
+}
+
+void MemFree(void *pMem)
+{
+    if (pMem == NULL){
+        return;
+    }
+
+    tUnMemHeader *pHeader = (tUnMemHeader *)pMem - 1;
+    stStats.astTag[pHeader->stInfo.eTag].uiFrees++;
+    stStats.astTag[pHeader->stInfo.eTag].uiBytes -= pHeader->stInfo.uiSize;
+    free(pHeader);
+}
+
+void MemStatic(size_t uiSize, tEnumMemTag eTag)
+{
+    stStats.astTag[eTag].uiStaticBytes = uiSize; // Set on every init, so calling it again does not count twice
+}
+
+void MemLock(bool xLock)
+{
+    xLocked = xLock;
+}
+
+void MemNextFrame()
+{
+    stStats.uiPeakFrameAllocs = stStats.uiFrameAllocs > stStats.uiPeakFrameAllocs ? stStats.uiFrameAllocs : stStats.uiPeakFrameAllocs;
+    stStats.uiFrameAllocs = 0;
+}
+
+tStMemStats MemGetStats()
+{
+    return stStats;
+}
@@ -0,0 +1,44 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// #define MEMTRACK_DEBUG // Assert when memory is allocated inside the frame loop
+
+typedef enum tEnumMemTag
+{
+    MemBoard, // Board of the game and of the tools
+    MemPlayout, // Board the win meter plays out on
+    MemRace, // Race table
+    MemEvaluator, // Track lookup of the evaluator
+    MemStrategy, // Strategy registry and its statistics
+    MemRender, // Vertex list and circle meshes
+    MemTags
+} tEnumMemTag;
+
+typedef struct tStMemCounter
+{
+    unsigned int uiAllocs;
+    unsigned int uiFrees;
+    size_t uiBytes; // Bytes in use
+    size_t uiPeakBytes; // High-water mark of uiBytes
+    size_t uiStaticBytes; // Tables the subsystem keeps in static storage
+} tStMemCounter;
+
+typedef struct tStMemStats
+{
+    tStMemCounter astTag[MemTags];
+    unsigned int uiFrameAllocs; // Allocations during the current frame
+    unsigned int uiPeakFrameAllocs;
+    unsigned int uiLockedAllocs; // Allocations while the frame loop was running
+} tStMemStats;
+
+void *MemAlloc(size_t uiSize, tEnumMemTag eTag);
+void MemFree(void *pMem);
+void MemStatic(size_t uiSize, tEnumMemTag eTag);
+void MemLock(bool xLock);
+void MemNextFrame();
+tStMemStats MemGetStats();
+
+#endif
@@ -0,0 +1,201 @@
+#include <time.h>
+#include "raceTable.h"
+#include "memTrack.h"
+
+#define RACE_SINGLE_STATES (RACE_TRACK*4) // One pawn left, three home slots taken
+#define RACE_STATES (RACE_SINGLE_STATES + RACE_TRACK*(RACE_TRACK+1)/2*6) // Two pawns left, two home slots taken
+#define RACE_SCALE 65535.0f
+
+static float arExpTurns[RACE_STATES]; // Expected amount of turns until all pawns are home
+static unsigned short aauiCdf[RACE_STATES][RACE_MAX_TURNS]; // Chance to have all pawns home within t+1 turns
+static tStRaceStats stStats;
+static bool xBuilt = false;
+
+// Rank of a home mask between the masks with the same amount of taken slots (-1 when not used by the table)
+static const signed char aiMaskRank[16] = {-1, -1, -1, 0, -1, 1, 2, 0, -1, 3, 4, 1, 5, 2, 3, -1};
+
+static unsigned short CountHomePawns(unsigned char uiMask)
+{
+    unsigned short uiCount = 0;
+
+    for (int i=0; i<4; i++){
+        uiCount += (uiMask >> i) & 1;
+    }
+
+    return uiCount;
+}
+
+static bool IsFinished(const tStRacePos *pstPos)
+{
+    return pstPos->uiNrOfPawns == 0 && pstPos->uiHomeMask == 0xF;
+}
+
+static int GetIndex(const tStRacePos *pstPos)
+{
+    if (pstPos->uiNrOfPawns + CountHomePawns(pstPos->uiHomeMask) != 4){ // Pawns left in the start area are not covered
+        return -1;
+    }
+
+    if (pstPos->uiNrOfPawns == 1 && pstPos->auiDist[0] < RACE_TRACK){
+        return pstPos->auiDist[0]*4 + aiMaskRank[pstPos->uiHomeMask];
+    } else if (pstPos->uiNrOfPawns == 2){
+        unsigned short uiLow = pstPos->auiDist[0] < pstPos->auiDist[1] ? pstPos->auiDist[0] : pstPos->auiDist[1];
+        unsigned short uiHigh = pstPos->auiDist[0] < pstPos->auiDist[1] ? pstPos->auiDist[1] : pstPos->auiDist[0];
+        if (uiHigh < RACE_TRACK && uiLow != uiHigh){ // Two pawns can never share a field
+            return RACE_SINGLE_STATES + (uiHigh*(uiHigh+1)/2 + uiLow)*6 + aiMaskRank[pstPos->uiHomeMask];
+        }
+    }
+
+    return -1;
+}
+
+static float GetCdf(const tStRacePos *pstPos, unsigned short uiTurns)
+{
+    if (IsFinished(pstPos)){
+        return 1;
+    } else if (uiTurns == 0){
+        return 0;
+    }
+
+    return aauiCdf[GetIndex(pstPos)][uiTurns-1] / RACE_SCALE;
+}
+
+bool RaceMove(const tStRacePos *pstPos, unsigned short uiPawn, unsigned short uiDice, tStRacePos *pstNext)
+{
+    unsigned short uiDist = pstPos->auiDist[uiPawn];
+    *pstNext = *pstPos;
+
+    if (uiDice <= uiDist){ // Pawn stays on the track
+        for (int i=0; i<pstPos->uiNrOfPawns; i++){
+            if (i != uiPawn && pstPos->auiDist[i] == uiDist - uiDice){ // Do not hit own pawn
+                return false;
+            }
+        }
+        pstNext->auiDist[uiPawn] = uiDist - uiDice;
+        return true;
+    }
+
+    // Same bounce back as SetPlayerInHome when there are more pips left than home slots
+    unsigned short uiMoves = uiDice - uiDist;
+    uiMoves = uiMoves > 4 ? uiMoves - (uiMoves%4)*2 : uiMoves;
+
+    if (pstPos->uiHomeMask & (1 << (uiMoves-1))){ // Home slot is already taken
+        return false;
+    }
+
+    pstNext->uiHomeMask |= 1 << (uiMoves-1);
+    pstNext->auiDist[uiPawn] = pstNext->auiDist[pstNext->uiNrOfPawns-1];
+    pstNext->uiNrOfPawns--;
+    return true;
+}
+
+static void SolvePosition(const tStRacePos *pstPos)
+{
+    int iIndex = GetIndex(pstPos);
+    tStRacePos astNext[7];
+    bool axMoved[7] = {false};
+    float rSum = 0;
+    float rSelf = 0;
+
+    // Pick the move with the lowest expected amount of turns for every dice value, all successors are already solved
+    for (int d=1; d<7; d++){
+        float rBest = 9999;
+        for (int i=0; i<pstPos->uiNrOfPawns; i++){
+            tStRacePos stNext;
+            if (RaceMove(pstPos, i, d, &stNext)){
+                float rTurns = RaceExpectedTurns(&stNext);
+                rTurns = d < 6 ? rTurns + 1 : (IsFinished(&stNext) ? 1 : rTurns); // Throwing 6 gives another throw in the same turn
+                if (rTurns < rBest){
+                    rBest = rTurns;
+                    astNext[d] = stNext;
+                    axMoved[d] = true;
+                }
+            }
+        }
+
+        if (axMoved[d]){
+            rSum += rBest;
+        } else{
+            rSum += d < 6 ? 1 : 0;
+            rSelf += 1;
+        }
+    }
+    arExpTurns[iIndex] = rSum / (6 - rSelf);
+
+    // Chance to be finished within t turns following the same moves
+    for (int t=1; t<=RACE_MAX_TURNS; t++){
+        float rCdf = 0;
+        for (int d=1; d<6; d++){
+            rCdf += axMoved[d] ? GetCdf(&astNext[d], t-1) : GetCdf(pstPos, t-1);
+        }
+        rCdf = axMoved[6] ? (rCdf + GetCdf(&astNext[6], t)) / 6 : rCdf / 5;
+        aauiCdf[iIndex][t-1] = rCdf * RACE_SCALE + 0.5f;
+    }
+}
+
+void RaceTableBuild()
+{
+    clock_t tStart = clock();
+    tStRacePos stPos;
+
+    // Retrograde order: moves only shorten the distance or take a pawn home, so solve the closest positions first
+    stPos.uiNrOfPawns = 1;
+    for (int d=0; d<RACE_TRACK; d++){
+        for (int m=0; m<16; m++){
+            if (CountHomePawns(m) == 3){
+                stPos.auiDist[0] = d; stPos.uiHomeMask = m;
+                SolvePosition(&stPos);
+            }
+        }
+    }
+
+    stPos.uiNrOfPawns = 2;
+    for (int s=1; s<2*RACE_TRACK-2; s++){
+        for (int d=s < RACE_TRACK ? 0 : s-RACE_TRACK+1; d<(s+1)/2; d++){
+            for (int m=0; m<16; m++){
+                if (CountHomePawns(m) == 2){
+                    stPos.auiDist[0] = d; stPos.auiDist[1] = s-d; stPos.uiHomeMask = m;
+                    SolvePosition(&stPos);
+                }
+            }
+        }
+    }
+
+    stStats.uiStates = RACE_STATES;
+    stStats.uiTableBytes = sizeof(arExpTurns) + sizeof(aauiCdf);
+    MemStatic(stStats.uiTableBytes, MemRace);
+    stStats.ulBuildTimeUs = (unsigned long)((clock() - tStart) * 1000000.0 / CLOCKS_PER_SEC);
+    xBuilt = true;
+}
+
+bool RaceTableCovers(const tStRacePos *pstPos)
+{
+    return xBuilt && (IsFinished(pstPos) || GetIndex(pstPos) >= 0);
+}
+
+float RaceExpectedTurns(const tStRacePos *pstPos)
+{
+    return IsFinished(pstPos) ? 0 : arExpTurns[GetIndex(pstPos)];
+}
+
+// Product of the finishing turn distributions of both players, which ignores that they share the track
+float RaceWinChance(const tStRacePos *pstMover, const tStRacePos *pstOther)
+{
+    float rWin = 0;
+
+    if (IsFinished(pstMover)){ // Already home, the cdf is 1 from turn 0 on and the sum below would stay empty
+        return 1;
+    }
+
+    // Mover wins when finishing in turn t while the other player needed more than t-1 turns
+    for (int t=1; t<=RACE_MAX_TURNS; t++){
+        rWin += (GetCdf(pstMover, t) - GetCdf(pstMover, t-1)) * (1 - GetCdf(pstOther, t-1));
+    }
+
+    return rWin;
+}
+
+tStRaceStats RaceTableGetStats()
+{
+    return stStats;
+}
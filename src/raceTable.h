@@ -0,0 +1,37 @@
+#ifndef RACETABLE_H
+#define RACETABLE_H
+
+#include <stdbool.h>
+
+// Approximate race table for the last pawns of a player, built in RAM when the game starts. It is not an
+// exact endgame solution:
+// - pawns never get hit, and positions with a pawn left in the start area are not covered
+// - at most RACE_MAX_PAWNS pawns are left on the track
+// - every player moves to finish in the fewest expected turns, not to win
+// - RaceWinChance treats the races of the two players as independent and cuts them after RACE_MAX_TURNS
+#define RACE_MAX_PAWNS 2 // Pawns left on the track which are covered by the table
+#define RACE_TRACK 40 // Distance to the home entry runs from 0 up to RACE_TRACK-1
+#define RACE_MAX_TURNS 64 // Amount of turns stored per position
+
+typedef struct tStRacePos
+{
+    unsigned char uiNrOfPawns; // Pawns on the track, the remaining pawns are home
+    unsigned char auiDist[RACE_MAX_PAWNS]; // Distance of each pawn to the home entry
+    unsigned char uiHomeMask; // Bit n is set when home slot n+1 is taken
+} tStRacePos;
+
+typedef struct tStRaceStats
+{
+    unsigned int uiStates;
+    unsigned int uiTableBytes;
+    unsigned long ulBuildTimeUs;
+} tStRaceStats;
+
+void RaceTableBuild();
+bool RaceTableCovers(const tStRacePos *pstPos);
+bool RaceMove(const tStRacePos *pstPos, unsigned short uiPawn, unsigned short uiDice, tStRacePos *pstNext);
+float RaceExpectedTurns(const tStRacePos *pstPos);
+float RaceWinChance(const tStRacePos *pstMover, const tStRacePos *pstOther);
+tStRaceStats RaceTableGetStats();
+
+#endif
@@ -0,0 +1,199 @@
+#include <math.h>
+#include <string.h>
+#include <psp2/kernel/processmgr.h>
+#include <psp2/kernel/sysmem.h>
+#include <psp2/gxm.h>
+#include <vita2d.h>
+#include "renderList.h"
+#include "memTrack.h"
+
+#define RENDER_STATIC_SIZE ((RENDER_STATIC_VERTICES * sizeof(vita2d_color_vertex) + 0xFFF) & ~0xFFF) // Memory blocks come in 4 KiB pages
+
+typedef struct tStCircleMesh
+{
+    unsigned short uiRadius;
+    unsigned short uiSegments;
+    float arX[RENDER_MAX_SEGMENTS+1]; // Outline of the circle around (0, 0)
+    float arY[RENDER_MAX_SEGMENTS+1];
+} tStCircleMesh;
+
+static vita2d_color_vertex astVertices[RENDER_MAX_VERTICES];
+static unsigned int uiNrOfVertices = 0;
+static tStCircleMesh astMeshes[RENDER_MAX_MESHES];
+static unsigned short uiNrOfMeshes = 0;
+static vita2d_color_vertex *pstStaticVertices = NULL; // GPU mapped, written once and drawn in every frame
+static unsigned int uiNrOfStatic = 0;
+static unsigned int uiStaticPrimitives = 0;
+static bool xRecordStatic = false;
+static unsigned long long ulBeginTime;
+static tStRenderStats stStats;
+static tStRenderStats stLastStats;
+
+static const tStCircleMesh *GetCircleMesh(unsigned short uiRadius)
+{
+    for (int k=0; k<uiNrOfMeshes; k++){
+        if (astMeshes[k].uiRadius == uiRadius){
+            return &astMeshes[k];
+        }
+    }
+
+    // Tessellate once, small circles get less segments than vita2d_draw_fill_circle would use
+    tStCircleMesh *pstMesh = &astMeshes[uiNrOfMeshes < RENDER_MAX_MESHES ? uiNrOfMeshes++ : uiRadius % RENDER_MAX_MESHES];
+    pstMesh->uiRadius = uiRadius;
+    pstMesh->uiSegments = uiRadius < 12 ? 12 : (uiRadius > RENDER_MAX_SEGMENTS ? RENDER_MAX_SEGMENTS : uiRadius);
+    for (int k=0; k<=pstMesh->uiSegments; k++){
+        float rTheta = 2 * M_PI * k / pstMesh->uiSegments;
+        pstMesh->arX[k] = uiRadius * cosf(rTheta);
+        pstMesh->arY[k] = uiRadius * sinf(rTheta);
+    }
+
+    return pstMesh;
+}
+
+void RenderInit()
+{
+    uiNrOfVertices = 0;
+    uiNrOfMeshes = 0;
+    MemStatic(sizeof(astVertices) + sizeof(astMeshes), MemRender);
+
+    // The static list outlives the frame pool, so it gets its own block which the GPU may read
+    void *pvBase = NULL;
+    SceUID iBlock = sceKernelAllocMemBlock("renderStatic", SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE, RENDER_STATIC_SIZE, NULL);
+    if (iBlock >= 0 && sceKernelGetMemBlockBase(iBlock, &pvBase) >= 0 && sceGxmMapMemory(pvBase, RENDER_STATIC_SIZE, SCE_GXM_MEMORY_ATTRIB_READ) >= 0){
+        pstStaticVertices = pvBase;
+        MemStatic(RENDER_STATIC_SIZE, MemRender);
+    } else if (iBlock >= 0){
+        sceKernelFreeMemBlock(iBlock);
+    }
+}
+
+static void AddVertex(float rX, float rY, unsigned int uiColor)
+{
+    vita2d_color_vertex *pstVertex = xRecordStatic ? &pstStaticVertices[uiNrOfStatic++] : &astVertices[uiNrOfVertices++];
+
+    pstVertex->x = rX;
+    pstVertex->y = rY;
+    pstVertex->z = +0.5f;
+    pstVertex->color = uiColor;
+}
+
+static void Submit()
+{
+    if (uiNrOfVertices == 0){
+        return;
+    }
+
+    // The GPU reads the vertices after this frame is built, so they go into the vita2d frame pool
+    vita2d_color_vertex *pstVertices = vita2d_pool_memalign(uiNrOfVertices * sizeof(vita2d_color_vertex), sizeof(vita2d_color_vertex));
+    if (pstVertices != NULL){
+        memcpy(pstVertices, astVertices, uiNrOfVertices * sizeof(vita2d_color_vertex));
+        vita2d_draw_array(SCE_GXM_PRIMITIVE_TRIANGLES, pstVertices, uiNrOfVertices);
+        stStats.uiDraws++;
+    }
+
+    stStats.uiVertices += uiNrOfVertices;
+    uiNrOfVertices = 0;
+}
+
+// Makes room for a shape, the static list cannot be flushed, so shapes which do not fit are dropped
+static bool Reserve(unsigned int uiCount)
+{
+    if (xRecordStatic){
+        return uiNrOfStatic + uiCount <= RENDER_STATIC_VERTICES;
+    }
+
+    if (uiNrOfVertices + uiCount > RENDER_MAX_VERTICES){
+        Submit();
+    }
+    return true;
+}
+
+static void CountPrimitive()
+{
+    if (xRecordStatic){
+        uiStaticPrimitives++;
+    } else{
+        stStats.uiPrimitives++;
+    }
+}
+
+void RenderBegin()
+{
+    ulBeginTime = sceKernelGetProcessTimeWide();
+    memset(&stStats, 0, sizeof(stStats));
+    uiNrOfVertices = 0;
+}
+
+void RenderRect(float rX, float rY, float rW, float rH, unsigned int uiColor)
+{
+    if (!Reserve(6)){
+        return;
+    }
+
+    AddVertex(rX, rY, uiColor);
+    AddVertex(rX+rW, rY, uiColor);
+    AddVertex(rX, rY+rH, uiColor);
+    AddVertex(rX+rW, rY, uiColor);
+    AddVertex(rX+rW, rY+rH, uiColor);
+    AddVertex(rX, rY+rH, uiColor);
+    CountPrimitive();
+}
+
+void RenderCircle(float rX, float rY, unsigned short uiRadius, unsigned int uiColor)
+{
+    const tStCircleMesh *pstMesh = GetCircleMesh(uiRadius);
+
+    if (!Reserve(3*pstMesh->uiSegments)){
+        return;
+    }
+
+    for (int k=0; k<pstMesh->uiSegments; k++){
+        AddVertex(rX, rY, uiColor);
+        AddVertex(rX + pstMesh->arX[k], rY + pstMesh->arY[k], uiColor);
+        AddVertex(rX + pstMesh->arX[k+1], rY + pstMesh->arY[k+1], uiColor);
+    }
+    CountPrimitive();
+}
+
+void RenderFlush()
+{
+    Submit();
+    stStats.ulDrawTimeUs = sceKernelGetProcessTimeWide() - ulBeginTime;
+    stLastStats = stStats;
+}
+
+// Shapes between RenderStaticBegin and RenderStaticEnd go into the static list instead of the frame
+bool RenderStaticBegin()
+{
+    if (pstStaticVertices == NULL){
+        return false;
+    }
+
+    uiNrOfStatic = 0;
+    uiStaticPrimitives = 0;
+    xRecordStatic = true;
+    return true;
+}
+
+void RenderStaticEnd()
+{
+    xRecordStatic = false;
+}
+
+// Draws the static list in place, the shapes collected so far are submitted first to keep the order
+void RenderStatic()
+{
+    Submit();
+
+    if (uiNrOfStatic > 0){
+        vita2d_draw_array(SCE_GXM_PRIMITIVE_TRIANGLES, pstStaticVertices, uiNrOfStatic);
+        stStats.uiDraws++;
+        stStats.uiPrimitives += uiStaticPrimitives;
+        stStats.uiStaticVertices += uiNrOfStatic;
+    }
+}
+
+tStRenderStats RenderGetStats()
+{
+    return stLastStats;
+}
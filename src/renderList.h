@@ -0,0 +1,30 @@
+#ifndef RENDERLIST_H
+#define RENDERLIST_H
+
+#include <stdbool.h>
+
+#define RENDER_MAX_VERTICES 24576 // Vertices collected per frame before the list is flushed early
+#define RENDER_MAX_MESHES 8 // Circle meshes kept in the cache, one per radius
+#define RENDER_MAX_SEGMENTS 32
+#define RENDER_STATIC_VERTICES 16384 // Vertices of the shapes that stay the same in every frame
+
+typedef struct tStRenderStats
+{
+    unsigned int uiDraws; // Draw calls submitted to the GPU this frame
+    unsigned int uiPrimitives; // Circles and rectangles this frame
+    unsigned int uiVertices; // Copied into the frame pool this frame
+    unsigned int uiStaticVertices; // Drawn from the static list without a copy
+    unsigned long long ulDrawTimeUs; // CPU time spent between RenderBegin and RenderFlush
+} tStRenderStats;
+
+void RenderInit();
+void RenderBegin();
+void RenderRect(float rX, float rY, float rW, float rH, unsigned int uiColor);
+void RenderCircle(float rX, float rY, unsigned short uiRadius, unsigned int uiColor);
+void RenderFlush();
+bool RenderStaticBegin();
+void RenderStaticEnd();
+void RenderStatic();
+tStRenderStats RenderGetStats();
+
+#endif
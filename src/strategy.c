@@ -0,0 +1,191 @@
+#include <string.h>
+#include "strategy.h"
+#include "evaluator.h"
+
+#ifndef __vita__
+#include <dlfcn.h>
+#endif
+
+static const tStStrategy stGreedy = {STRATEGY_ABI_VERSION, "greedy", NULL, PickPawnComputer};
+static const tStStrategy stEvaluator = {STRATEGY_ABI_VERSION, "evaluator", EvaluateBatch, NULL};
+
+static const tStStrategy *apstStrategies[STRATEGY_MAX];
+static tStStrategyStats astStats[STRATEGY_MAX];
+static unsigned short uiNrOfStrategies = 0;
+static int aiSeats[5]; // Strategy per player (tEnumPlayer/POFF)
+static tGetTimeUs pfGetTime;
+
+void StrategyInit(tGetTimeUs pfNow)
+{
+    pfGetTime = pfNow;
+    uiNrOfStrategies = 0;
+    StrategyRegister(&stGreedy);
+    StrategyRegister(&stEvaluator);
+
+    // Greedy consults the race table first, the evaluator is not stronger in a seat-balanced match and stays opt-in
+    for (int p=0; p<5; p++){
+        aiSeats[p] = StrategyFind(stGreedy.pcName);
+    }
+    MemStatic(sizeof(apstStrategies) + sizeof(astStats) + sizeof(aiSeats), MemStrategy);
+}
+
+int StrategyRegister(const tStStrategy *pstStrategy)
+{
+    if (pstStrategy == NULL || pstStrategy->uiAbiVersion != STRATEGY_ABI_VERSION || uiNrOfStrategies >= STRATEGY_MAX){
+        return -1;
+    } else if (pstStrategy->pfEvaluate == NULL && pstStrategy->pfPick == NULL){
+        return -1;
+    }
+
+    apstStrategies[uiNrOfStrategies] = pstStrategy;
+    memset(&astStats[uiNrOfStrategies], 0, sizeof(tStStrategyStats));
+    return uiNrOfStrategies++;
+}
+
+int StrategyLoad(const char *pcPath)
+{
+#ifndef __vita__
+    void *pvLib = dlopen(pcPath, RTLD_NOW | RTLD_LOCAL);
+    if (pvLib == NULL){
+        return -1;
+    }
+
+    tGetStrategy pfGet = (tGetStrategy)dlsym(pvLib, STRATEGY_ENTRY);
+    int iStrategy = pfGet != NULL ? StrategyRegister(pfGet()) : -1;
+    if (iStrategy < 0){
+        dlclose(pvLib);
+    }
+
+    return iStrategy; // The library stays loaded for the lifetime of the process
+#else
+    (void)pcPath; // No dynamic loading on the Vita, strategies are linked in and registered
+    return -1;
+#endif
+}
+
+int StrategyFind(const char *pcName)
+{
+    for (int k=0; k<uiNrOfStrategies; k++){
+        if (strcmp(apstStrategies[k]->pcName, pcName) == 0){
+            return k;
+        }
+    }
+
+    return -1;
+}
+
+unsigned short StrategyCount()
+{
+    return uiNrOfStrategies;
+}
+
+const char *StrategyName(int iStrategy)
+{
+    return apstStrategies[iStrategy]->pcName;
+}
+
+void StrategySetSeat(tEnumPlayer ePlayer, int iStrategy)
+{
+    if (iStrategy >= 0 && iStrategy < uiNrOfStrategies){
+        aiSeats[ePlayer/POFF] = iStrategy;
+    }
+}
+
+int StrategyGetSeat(tEnumPlayer ePlayer)
+{
+    return aiSeats[ePlayer/POFF];
+}
+
+// Picks a pawn for every dice value from uiFirst to uiLast, the positions after all their legal moves are scored in one call
+static void PickBatched(tStGame *stGame, unsigned short uiFirst, unsigned short uiLast, int iStrategy, tStPosition *astPicks)
+{
+    tStSnapshot astCandidates[STRATEGY_BATCH];
+    tStPosition astPawns[STRATEGY_BATCH];
+    unsigned short auiDice[STRATEGY_BATCH];
+    int aiScores[STRATEGY_BATCH];
+    int aiBest[7] = {0};
+    unsigned int uiCount = 0;
+
+    for (unsigned short uiDice=uiFirst; uiDice<=uiLast; uiDice++){
+        astPicks[uiDice].uiRowIndex = -1;
+        astPicks[uiDice].uiColIndex = -1;
+        for (int i=0; i<stGame->uiFieldHeight && uiCount<STRATEGY_BATCH; i++){
+            for (int j=0; j<stGame->uiFieldWidth && uiCount<STRATEGY_BATCH; j++){
+                tStPosition stPawn = ChoosePawn(stGame, i, j);
+                tStMove stMove;
+                if (stPawn.uiColIndex <= stGame->uiFieldWidth && MakeMove(stGame, stPawn, uiDice, &stMove)){
+                    SaveSnapshot(stGame, &astCandidates[uiCount]);
+                    UnmakeMove(stGame, &stMove);
+                    astPawns[uiCount] = stPawn;
+                    auiDice[uiCount++] = uiDice;
+                }
+            }
+        }
+    }
+
+    if (uiCount > 0){
+        unsigned long long ulStart = pfGetTime();
+        apstStrategies[iStrategy]->pfEvaluate(astCandidates, uiCount, stGame->eTurn, aiScores);
+        astStats[iStrategy].ulEvaluateUs += pfGetTime() - ulStart;
+        astStats[iStrategy].uiPositions += uiCount;
+        astStats[iStrategy].uiBatches++;
+    }
+
+    for (unsigned int n=0; n<uiCount; n++){
+        unsigned short uiDice = auiDice[n];
+        if (astPicks[uiDice].uiColIndex > stGame->uiFieldWidth || aiScores[n] > aiBest[uiDice]){
+            aiBest[uiDice] = aiScores[n];
+            astPicks[uiDice] = astPawns[n];
+        }
+    }
+
+    for (unsigned short uiDice=uiFirst; uiDice<=uiLast; uiDice++){
+        if (astPicks[uiDice].uiColIndex > stGame->uiFieldWidth){ // No pawn is able to move, leave it to the greedy rule
+            astPicks[uiDice] = PickPawnComputer(stGame, uiDice);
+        }
+    }
+}
+
+static void CountPicks(int iStrategy, unsigned int uiPicks, unsigned long long ulTime)
+{
+    astStats[iStrategy].uiPicks += uiPicks;
+    astStats[iStrategy].ulPickUs += ulTime;
+    astStats[iStrategy].ulMaxPickUs = ulTime > astStats[iStrategy].ulMaxPickUs ? ulTime : astStats[iStrategy].ulMaxPickUs;
+}
+
+tStPosition PickPawnStrategy(tStGame *stGame, unsigned short uiDice)
+{
+    int iStrategy = aiSeats[stGame->eTurn/POFF];
+    unsigned long long ulStart = pfGetTime();
+    tStPosition astPicks[7];
+
+    if (apstStrategies[iStrategy]->pfPick != NULL){
+        astPicks[uiDice] = apstStrategies[iStrategy]->pfPick(stGame, uiDice);
+    } else{
+        PickBatched(stGame, uiDice, uiDice, iStrategy, astPicks);
+    }
+
+    CountPicks(iStrategy, 1, pfGetTime() - ulStart);
+    return astPicks[uiDice];
+}
+
+void StrategyPickAll(tStGame *stGame, tStPosition *astPicks)
+{
+    int iStrategy = aiSeats[stGame->eTurn/POFF];
+    unsigned long long ulStart = pfGetTime();
+
+    if (apstStrategies[iStrategy]->pfPick != NULL){
+        for (unsigned short uiDice=1; uiDice<7; uiDice++){
+            astPicks[uiDice] = apstStrategies[iStrategy]->pfPick(stGame, uiDice);
+        }
+    } else{
+        PickBatched(stGame, 1, 6, iStrategy, astPicks);
+    }
+
+    CountPicks(iStrategy, 6, pfGetTime() - ulStart);
+}
+
+tStStrategyStats StrategyGetStats(int iStrategy)
+{
+    return astStats[iStrategy];
+}
@@ -0,0 +1,48 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <stddef.h>
+#include "gameRules.h"
+
+// Plug-in interface for the computer players. A shared object exports STRATEGY_ENTRY which returns a
+// tStStrategy, on the Vita the same structure is linked into the binary and passed to StrategyRegister.
+// Plug-ins only see tStSnapshot positions, so they do not depend on the layout of tStGame.
+#define STRATEGY_ABI_VERSION 1
+#define STRATEGY_ENTRY "GetStrategy"
+#define STRATEGY_MAX 8 // Strategies which can be registered at the same time
+#define STRATEGY_BATCH 24 // Candidate positions per call of pfEvaluate, every pawn for every dice value
+
+typedef struct tStStrategy
+{
+    unsigned int uiAbiVersion; // Set to STRATEGY_ABI_VERSION
+    const char *pcName;
+    // Scores uiCount positions after a move of ePlayer, the highest score is played
+    void (*pfEvaluate)(const tStSnapshot *astPositions, unsigned int uiCount, tEnumPlayer ePlayer, int *aiScores);
+    tPickPawn pfPick; // Only for strategies linked into the game, plug-ins leave it NULL and use pfEvaluate
+} tStStrategy;
+
+typedef const tStStrategy *(*tGetStrategy)();
+
+typedef struct tStStrategyStats
+{
+    unsigned int uiPicks;
+    unsigned int uiPositions; // Positions passed to pfEvaluate
+    unsigned int uiBatches; // Calls of pfEvaluate
+    unsigned long long ulPickUs; // Time spent in picks, including move generation
+    unsigned long long ulEvaluateUs; // Time spent in pfEvaluate
+    unsigned long long ulMaxPickUs; // Longest single call, StrategyPickAll counts as one
+} tStStrategyStats;
+
+void StrategyInit(tGetTimeUs pfNow);
+int StrategyRegister(const tStStrategy *pstStrategy);
+int StrategyLoad(const char *pcPath);
+int StrategyFind(const char *pcName);
+unsigned short StrategyCount();
+const char *StrategyName(int iStrategy);
+void StrategySetSeat(tEnumPlayer ePlayer, int iStrategy);
+int StrategyGetSeat(tEnumPlayer ePlayer);
+tStPosition PickPawnStrategy(tStGame *stGame, unsigned short uiDice);
+void StrategyPickAll(tStGame *stGame, tStPosition *astPicks); // Picks for the dice values 1-6 of the same position, batched in one call
+tStStrategyStats StrategyGetStats(int iStrategy);
+
+#endif
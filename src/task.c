@@ -0,0 +1,44 @@
+#include <string.h>
+#include "task.h"
+
+void TaskInit(tStScheduler *pstScheduler)
+{
+    memset(pstScheduler, 0, sizeof(tStScheduler));
+}
+
+bool TaskAdd(tStScheduler *pstScheduler, tStTask *pstTask, tTaskRun pfRun, void *pvCtx)
+{
+    if (pstScheduler->uiNrOfTasks >= TASK_MAX){
+        return false;
+    }
+
+    pstTask->uiLine = 0;
+    pstTask->eWait = TaskReady;
+    pstTask->pfRun = pfRun;
+    pstTask->pvCtx = pvCtx;
+    pstScheduler->apstTasks[pstScheduler->uiNrOfTasks++] = pstTask;
+    return true;
+}
+
+void TaskSignal(tStScheduler *pstScheduler, tEnumTaskEvent eEvent)
+{
+    pstScheduler->uiSignals |= 1u << eEvent;
+}
+
+void TaskRun(tStScheduler *pstScheduler)
+{
+    // Events raised while the tasks run are kept for the next pass
+    unsigned int uiSignals = pstScheduler->uiSignals | 1u << TaskReady;
+    pstScheduler->uiSignals = 0;
+
+    for (int k=0; k<pstScheduler->uiNrOfTasks; k++){
+        tStTask *pstTask = pstScheduler->apstTasks[k];
+
+        if (pstTask->eWait != TaskDone && (uiSignals & 1u << pstTask->eWait)){
+            pstTask->pfRun(pstTask);
+            pstScheduler->uiResumes++;
+        } else{
+            pstScheduler->uiSkips++;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdbool.h>
+
+// Stackless coroutines, a task function resumes at the wait it returned from. Locals do not survive a
+// wait, keep the state of a task in its context. Waits must not be placed inside a switch of the task
+// and only one wait fits on a source line.
+#define TASK_MAX 4
+
+typedef enum tEnumTaskEvent
+{
+    TaskReady, // Runs on the next pass of the scheduler
+    TaskFrame, // Raised once per frame
+    TaskInput, // A button, the d-pad or the touchscreen was triggered
+    TaskAnimation, // The pawn animation finished
+    TaskDone // Returned from the end of the task, never runs again
+} tEnumTaskEvent;
+
+typedef struct tStTask tStTask;
+typedef void (*tTaskRun)(tStTask *pstTask);
+
+struct tStTask
+{
+    unsigned int uiLine; // Resume point, 0 starts from the top
+    tEnumTaskEvent eWait; // Event the task sleeps on
+    tTaskRun pfRun;
+    void *pvCtx;
+};
+
+typedef struct tStScheduler
+{
+    tStTask *apstTasks[TASK_MAX];
+    unsigned short uiNrOfTasks;
+    unsigned int uiSignals; // Bit per tEnumTaskEvent raised since the last run
+    unsigned int uiResumes; // Tasks which were run
+    unsigned int uiSkips; // Tasks left asleep because their event was not raised
+} tStScheduler;
+
+#define TASK_BEGIN(pstTask) switch ((pstTask)->uiLine){ case 0:
+
+// Continues at once when the condition already holds, otherwise the condition is tested again whenever the event is raised.
+// Falling into the resume point is intended, the attribute keeps -Wimplicit-fallthrough quiet.
+#define TASK_WAIT_UNTIL(pstTask, eEvent, xCondition) \
+    do{ (pstTask)->uiLine = __LINE__; (pstTask)->eWait = (eEvent); __attribute__((fallthrough)); case __LINE__: if (!(xCondition)) return; (pstTask)->eWait = TaskReady; } while (0)
+
+// Always gives up the rest of this run and continues when the event is raised
+#define TASK_WAIT(pstTask, eEvent) \
+    do{ (pstTask)->uiLine = __LINE__; (pstTask)->eWait = (eEvent); return; case __LINE__: (pstTask)->eWait = TaskReady; } while (0)
+
+#define TASK_END(pstTask) } (pstTask)->eWait = TaskDone
+
+void TaskInit(tStScheduler *pstScheduler);
+bool TaskAdd(tStScheduler *pstScheduler, tStTask *pstTask, tTaskRun pfRun, void *pvCtx);
+void TaskSignal(tStScheduler *pstScheduler, tEnumTaskEvent eEvent);
+void TaskRun(tStScheduler *pstScheduler);
+
+#endif
@@ -0,0 +1,84 @@
+#include <math.h>
+#include "winMeter.h"
+
+void WinMeterInit(tStWinMeter *stMeter, tStGame *stGame)
+{
+    stMeter->stPlayout.uiFieldHeight = stGame->uiFieldHeight;
+    stMeter->stPlayout.uiFieldWidth = stGame->uiFieldWidth;
+    BoardConstructorTagged(&stMeter->stPlayout, MemPlayout);
+    SeedDice(&stMeter->stPlayout, stGame->uiSeed ^ 0x9E3779B9);
+    stMeter->uiTotalPlayouts = 0;
+    stMeter->ulBusyUs = 0;
+}
+
+void WinMeterRestart(tStWinMeter *stMeter, tStGame *stGame, tGetTimeUs pfNow)
+{
+    SaveSnapshot(stGame, &stMeter->stRoot);
+    LoadSnapshot(&stMeter->stPlayout, &stMeter->stRoot);
+    stMeter->uiTurns = 0;
+    stMeter->uiPlayouts = 0;
+    for (int p=0; p<5; p++){
+        stMeter->auiWins[p] = 0;
+    }
+    stMeter->ulRestartTime = pfNow();
+    stMeter->ulConvergeUs = 0;
+}
+
+void WinMeterUpdate(tStWinMeter *stMeter, unsigned long long ulBudgetUs, tGetTimeUs pfNow)
+{
+    unsigned long long ulStart = pfNow();
+    unsigned long long ulNow = ulStart;
+
+    // Play turns of the current playout until the budget is used, a playout may span several frames
+    while (ulNow - ulStart < ulBudgetUs){
+        bool xWon = PlayTurn(&stMeter->stPlayout, PickPawnComputer);
+        stMeter->uiTurns++;
+
+        if (xWon || stMeter->uiTurns >= WINMETER_MAX_TURNS){
+            if (xWon){
+                stMeter->auiWins[stMeter->stPlayout.eTurn/POFF]++;
+                stMeter->uiPlayouts++;
+                stMeter->uiTotalPlayouts++;
+            }
+            LoadSnapshot(&stMeter->stPlayout, &stMeter->stRoot);
+            stMeter->uiTurns = 0;
+        } else{
+            SwitchPlayer(&stMeter->stPlayout);
+        }
+        ulNow = pfNow();
+    }
+    stMeter->ulBusyUs += ulNow - ulStart;
+
+    if (stMeter->ulConvergeUs == 0 && stMeter->uiPlayouts > 0){
+        float rWidest = 0;
+        for (tEnumPlayer ePlayer=PlayerOne; ePlayer<=PlayerFour; ePlayer+=POFF){
+            float rHalfWidth;
+            WinMeterChance(stMeter, ePlayer, &rHalfWidth);
+            rWidest = rHalfWidth > rWidest ? rHalfWidth : rWidest;
+        }
+        if (rWidest < WINMETER_CONVERGED){
+            stMeter->ulConvergeUs = ulNow - stMeter->ulRestartTime;
+        }
+    }
+}
+
+float WinMeterChance(tStWinMeter *stMeter, tEnumPlayer ePlayer, float *prHalfWidth)
+{
+    if (stMeter->uiPlayouts == 0){
+        *prHalfWidth = 0.5f;
+        return 0.25f;
+    }
+
+    float rChance = (float)stMeter->auiWins[ePlayer/POFF] / stMeter->uiPlayouts;
+    *prHalfWidth = 1.96f * sqrtf(rChance * (1 - rChance) / stMeter->uiPlayouts); // Normal approximation of the 95% interval
+    if (*prHalfWidth == 0){ // All or none of the playouts were won, fall back to the rule of three
+        *prHalfWidth = 3.0f / stMeter->uiPlayouts;
+    }
+
+    return rChance;
+}
+
+float WinMeterPlayoutsPerSec(tStWinMeter *stMeter)
+{
+    return stMeter->ulBusyUs > 0 ? stMeter->uiTotalPlayouts * 1e6f / stMeter->ulBusyUs : 0;
+}
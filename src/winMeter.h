@@ -0,0 +1,28 @@
+#ifndef WINMETER_H
+#define WINMETER_H
+
+#include "gameRules.h"
+
+#define WINMETER_MAX_TURNS 4000 // Playouts without a winner after this many turns are dropped
+#define WINMETER_CONVERGED 0.05f // Half width of the 95% interval at which the estimate counts as settled
+
+typedef struct tStWinMeter
+{
+    tStGame stPlayout; // Board of the playout in progress, continued in the next frame when the budget runs out
+    tStSnapshot stRoot; // Position the estimate belongs to
+    unsigned short uiTurns; // Turns played in the current playout
+    unsigned int auiWins[5];
+    unsigned int uiPlayouts; // Finished playouts since the last restart
+    unsigned int uiTotalPlayouts;
+    unsigned long long ulBusyUs; // Time spent on playouts in total
+    unsigned long long ulRestartTime;
+    unsigned long long ulConvergeUs; // Time from the restart until the estimate settled, 0 while it has not
+} tStWinMeter;
+
+void WinMeterInit(tStWinMeter *stMeter, tStGame *stGame);
+void WinMeterRestart(tStWinMeter *stMeter, tStGame *stGame, tGetTimeUs pfNow);
+void WinMeterUpdate(tStWinMeter *stMeter, unsigned long long ulBudgetUs, tGetTimeUs pfNow);
+float WinMeterChance(tStWinMeter *stMeter, tEnumPlayer ePlayer, float *prHalfWidth);
+float WinMeterPlayoutsPerSec(tStWinMeter *stMeter);
+
+#endif
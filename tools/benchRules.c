@@ -0,0 +1,537 @@
+// Microbenchmarks of the board rules on a Linux host, compared against a stored baseline
+// Build: gcc -O2 -Isrc -o benchRules tools/benchRules.c src/gameRules.c src/raceTable.c src/memTrack.c -lm
+// Usage: ./benchRules [positions] [--json file] [--baseline file] [--threshold percent]
+// Exits with 1 when a benchmark is slower than in the baseline by more than the threshold (default 10%), benchmarks
+// whose spread in this run or in the baseline reaches the threshold are reported but not gated.
+// Write a new baseline with --json tools/benchRules.json after a deliberate change, on the machine that checks it
+// while nothing else runs, and keep the run with the lowest spreads.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "gameRules.h"
+
+#define SAMPLES 31 // Measurements per benchmark, the median is reported
+#define SAMPLE_NS 2e6 // Passes over the corpus are repeated until a measurement takes about this long
+#define CALIBRATION_STEPS 100000 // Steps of the reference loop timed with every sample
+#define TOUCHES 1024
+#define PERF_EVENTS 4
+#define ATTEMPTS 3 // A noisy benchmark or one over the threshold is measured again, a slow phase of the machine is not a regression
+
+typedef struct tStCase
+{
+    unsigned short uiBoard;
+    unsigned short uiDice;
+    tStPosition stPawn;
+    tStPosition stNewPos; // Result of MovePawn
+    tStPosition stYard; // Start area field CheckHit puts a hitted pawn on, -1 when nothing is hit
+    bool xLegal;
+} tStCase;
+
+typedef struct tStCorpus
+{
+    int iPositions;
+    tStGame *astBoards; // One board per position, so no benchmark has to reload a position
+    tStSnapshot *astPositions;
+    tStCase *astCases; // Every pawn on the track of the player in turn with every dice value
+    int iCases;
+    unsigned short aauiTouch[TOUCHES][2];
+} tStCorpus;
+
+typedef unsigned long (*tBenchRun)(tStCorpus *pstCorpus); // One pass, returns the number of calls
+
+typedef struct tStBench
+{
+    const char *pcName;
+    tBenchRun pfRun;
+} tStBench;
+
+typedef struct tStResult
+{
+    double rNsPerOp; // Median of the samples
+    double rMinNs;
+    double rSpread; // Interquartile range relative to the median
+    double rCalibNs; // Fastest step of the reference loop while this benchmark ran
+    unsigned long ulOps;
+    double arPerOp[PERF_EVENTS]; // Hardware counters per call, negative when not available
+} tStResult;
+
+static volatile unsigned int uiSink; // Keeps the compiler from dropping calls whose result is unused
+
+static const char *apcPerfNames[PERF_EVENTS] = {"cycles", "instructions", "branch_misses", "cache_misses"};
+static int aiPerfFd[PERF_EVENTS] = {-1, -1, -1, -1};
+
+static double GetTimeNs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1e9 + stTime.tv_nsec;
+}
+
+// Fixed work which only depends on the speed of the core. Comparing against the baseline relative to it
+// cancels out a different clock or a throttled machine.
+static double Calibrate()
+{
+    unsigned int uiState = uiSink | 1;
+    double rStart = GetTimeNs();
+    for (int k=0; k<CALIBRATION_STEPS; k++){
+        uiState ^= uiState << 13;
+        uiState ^= uiState >> 17;
+        uiState ^= uiState << 5;
+    }
+    double rTime = GetTimeNs() - rStart;
+    uiSink += uiState;
+    return rTime / CALIBRATION_STEPS;
+}
+
+static void PerfOpen()
+{
+#ifdef __linux__
+    static const unsigned long long aulConfig[PERF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+    for (int e=0; e<PERF_EVENTS; e++){
+        struct perf_event_attr stAttr;
+        memset(&stAttr, 0, sizeof(stAttr));
+        stAttr.size = sizeof(stAttr);
+        stAttr.type = PERF_TYPE_HARDWARE;
+        stAttr.config = aulConfig[e];
+        stAttr.disabled = 1;
+        stAttr.exclude_kernel = 1; // Allowed without privileges up to perf_event_paranoid 2
+        stAttr.exclude_hv = 1;
+        aiPerfFd[e] = syscall(SYS_perf_event_open, &stAttr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+static void PerfControl(unsigned long ulRequest)
+{
+#ifdef __linux__
+    for (int e=0; e<PERF_EVENTS; e++){
+        if (aiPerfFd[e] >= 0){
+            ioctl(aiPerfFd[e], ulRequest, 0);
+        }
+    }
+#endif
+}
+
+static void PerfStop(double *arPerOp, unsigned long ulOps)
+{
+    for (int e=0; e<PERF_EVENTS; e++){
+        long long lCount = -1;
+#ifdef __linux__
+        if (aiPerfFd[e] >= 0){
+            if (read(aiPerfFd[e], &lCount, sizeof(lCount)) != sizeof(lCount)){
+                lCount = -1;
+            }
+        }
+#endif
+        arPerOp[e] = lCount < 0 ? -1 : (double)lCount / ulOps;
+    }
+}
+
+static bool PerfAvailable()
+{
+    for (int e=0; e<PERF_EVENTS; e++){
+        if (aiPerfFd[e] >= 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+static void BuildCorpus(tStCorpus *pstCorpus, int iPositions)
+{
+    tStGame stGame;
+
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    SeedDice(&stGame, 1);
+
+    pstCorpus->iPositions = iPositions;
+    pstCorpus->astBoards = malloc(sizeof(tStGame) * iPositions);
+    pstCorpus->astPositions = malloc(sizeof(tStSnapshot) * iPositions);
+    pstCorpus->astCases = malloc(sizeof(tStCase) * iPositions * 4 * 6);
+    pstCorpus->iCases = 0;
+
+    // Mid-game positions taken from games between greedy players
+    for (int n=0; n<iPositions; n++){
+        if (n % 20 == 0){
+            BoardInitializer(&stGame);
+            stGame.eTurn = PlayerOne;
+        }
+        for (int t=0; t<8; t++){
+            if (PlayTurn(&stGame, PickPawnComputer)){
+                BoardInitializer(&stGame);
+            }
+            SwitchPlayer(&stGame);
+        }
+        SaveSnapshot(&stGame, &pstCorpus->astPositions[n]);
+
+        tStGame *pstBoard = &pstCorpus->astBoards[n];
+        pstBoard->uiFieldHeight = FIELD_SIZE;
+        pstBoard->uiFieldWidth = FIELD_SIZE;
+        BoardConstructor(pstBoard);
+        LoadSnapshot(pstBoard, &pstCorpus->astPositions[n]);
+        pstBoard->uiSeed = stGame.uiSeed;
+
+        for (int i=0; i<FIELD_SIZE; i++){
+            for (int j=0; j<FIELD_SIZE; j++){
+                tStPosition stPawn = ChoosePawn(pstBoard, i, j);
+                for (unsigned short uiDice=1; uiDice<=6 && stPawn.uiColIndex <= FIELD_SIZE; uiDice++){
+                    tStCase *pstCase = &pstCorpus->astCases[pstCorpus->iCases++];
+                    pstCase->uiBoard = n;
+                    pstCase->uiDice = uiDice;
+                    pstCase->stPawn = stPawn;
+                    pstCase->stNewPos = MovePawn(pstBoard, i, j, uiDice);
+                    pstCase->xLegal = IsMoveLegal(pstBoard, stPawn, uiDice);
+                    pstCase->stYard.uiRowIndex = -1;
+                    pstCase->stYard.uiColIndex = -1;
+
+                    tEnumPlayer eTarget = pstBoard->Field[pstCase->stNewPos.uiRowIndex][pstCase->stNewPos.uiColIndex].eData;
+                    if (pstCase->stNewPos.uiMovesLeft == 0 && eTarget % POFF == 0){
+                        pstCase->stYard = CheckStartPos(pstBoard, eTarget, true);
+                    }
+                }
+            }
+        }
+    }
+
+    // Taps spread over the whole screen, like the touch handler of the game gets them
+    srand(1);
+    for (int t=0; t<TOUCHES; t++){
+        pstCorpus->aauiTouch[t][0] = rand() % WIDTH;
+        pstCorpus->aauiTouch[t][1] = rand() % HEIGHT;
+    }
+
+    BoardDestructor(&stGame);
+}
+
+static void FreeCorpus(tStCorpus *pstCorpus)
+{
+    for (int n=0; n<pstCorpus->iPositions; n++){
+        BoardDestructor(&pstCorpus->astBoards[n]);
+    }
+    free(pstCorpus->astBoards);
+    free(pstCorpus->astPositions);
+    free(pstCorpus->astCases);
+}
+
+static unsigned long BenchMovePawn(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int c=0; c<pstCorpus->iCases; c++){
+        tStCase *pstCase = &pstCorpus->astCases[c];
+        uiSum += MovePawn(&pstCorpus->astBoards[pstCase->uiBoard], pstCase->stPawn.uiRowIndex, pstCase->stPawn.uiColIndex, pstCase->uiDice).uiColIndex;
+    }
+    uiSink += uiSum;
+    return pstCorpus->iCases;
+}
+
+static unsigned long BenchGetDistToHomePos(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int c=0; c<pstCorpus->iCases; c+=6){ // The distance does not depend on the dice
+        tStCase *pstCase = &pstCorpus->astCases[c];
+        uiSum += GetDistToHomePos(&pstCorpus->astBoards[pstCase->uiBoard], pstCase->stPawn);
+    }
+    uiSink += uiSum;
+    return pstCorpus->iCases / 6;
+}
+
+static unsigned long BenchSetPlayerInHome(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int c=0; c<pstCorpus->iCases; c++){
+        tStCase *pstCase = &pstCorpus->astCases[c];
+        uiSum += SetPlayerInHome(&pstCorpus->astBoards[pstCase->uiBoard], pstCase->stNewPos).uiMovesLeft;
+    }
+    uiSink += uiSum;
+    return pstCorpus->iCases;
+}
+
+// Includes putting back the two fields CheckHit changes
+static unsigned long BenchCheckHit(tStCorpus *pstCorpus)
+{
+    unsigned long ulOps = 0;
+    unsigned int uiSum = 0;
+    for (int c=0; c<pstCorpus->iCases; c++){
+        tStCase *pstCase = &pstCorpus->astCases[c];
+        if (pstCase->xLegal && pstCase->stNewPos.uiMovesLeft == 0){
+            tStGame *pstBoard = &pstCorpus->astBoards[pstCase->uiBoard];
+            uiSum += CheckHit(pstBoard, pstCase->stNewPos, pstCase->stPawn).uiColIndex;
+            pstBoard->Field[pstCase->stPawn.uiRowIndex][pstCase->stPawn.uiColIndex].eData = pstBoard->eTurn;
+            if (pstCase->stYard.uiColIndex < FIELD_SIZE){
+                pstBoard->Field[pstCase->stYard.uiRowIndex][pstCase->stYard.uiColIndex].eData = Empty;
+            }
+            ulOps++;
+        }
+    }
+    uiSink += uiSum;
+    return ulOps;
+}
+
+static unsigned long BenchCheckWinner(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int n=0; n<pstCorpus->iPositions; n++){
+        uiSum += CheckWinner(&pstCorpus->astBoards[n]);
+    }
+    uiSink += uiSum;
+    return pstCorpus->iPositions;
+}
+
+static unsigned long BenchGetNumberOfSummonedPawns(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int n=0; n<pstCorpus->iPositions; n++){
+        uiSum += GetNumberOfSummonedPawns(&pstCorpus->astBoards[n]);
+    }
+    uiSink += uiSum;
+    return pstCorpus->iPositions;
+}
+
+static unsigned long BenchPickPawnComputer(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int n=0; n<pstCorpus->iPositions; n++){
+        for (unsigned short uiDice=1; uiDice<=6; uiDice++){
+            uiSum += PickPawnComputer(&pstCorpus->astBoards[n], uiDice).uiColIndex;
+        }
+    }
+    uiSink += uiSum;
+    return pstCorpus->iPositions * 6;
+}
+
+static unsigned long BenchGetClosestField(tStCorpus *pstCorpus)
+{
+    unsigned int uiSum = 0;
+    for (int t=0; t<TOUCHES; t++){
+        uiSum += GetClosestField(&pstCorpus->astBoards[0], pstCorpus->aauiTouch[t][0], pstCorpus->aauiTouch[t][1]).uiColIndex;
+    }
+    uiSink += uiSum;
+    return TOUCHES;
+}
+
+static unsigned long BenchMakeUnmake(tStCorpus *pstCorpus)
+{
+    unsigned long ulOps = 0;
+    tStMove stMove;
+    for (int c=0; c<pstCorpus->iCases; c++){
+        tStCase *pstCase = &pstCorpus->astCases[c];
+        if (pstCase->xLegal){
+            MakeMove(&pstCorpus->astBoards[pstCase->uiBoard], pstCase->stPawn, pstCase->uiDice, &stMove);
+            UnmakeMove(&pstCorpus->astBoards[pstCase->uiBoard], &stMove);
+            ulOps++;
+        }
+    }
+    return ulOps;
+}
+
+static unsigned long BenchSnapshot(tStCorpus *pstCorpus)
+{
+    tStSnapshot stSnapshot;
+    for (int n=0; n<pstCorpus->iPositions; n++){
+        SaveSnapshot(&pstCorpus->astBoards[n], &stSnapshot);
+        LoadSnapshot(&pstCorpus->astBoards[n], &stSnapshot);
+    }
+    uiSink += stSnapshot.auiData[FIELD_SIZE*FIELD_SIZE/2];
+    return pstCorpus->iPositions;
+}
+
+static const tStBench astBenches[] = {
+    {"MovePawn", BenchMovePawn},
+    {"GetDistToHomePos", BenchGetDistToHomePos},
+    {"SetPlayerInHome", BenchSetPlayerInHome},
+    {"CheckHit", BenchCheckHit},
+    {"CheckWinner", BenchCheckWinner},
+    {"GetNumberOfSummonedPawns", BenchGetNumberOfSummonedPawns},
+    {"PickPawnComputer", BenchPickPawnComputer},
+    {"GetClosestField", BenchGetClosestField},
+    {"MakeUnmake", BenchMakeUnmake},
+    {"SnapshotSaveLoad", BenchSnapshot}
+};
+#define NR_OF_BENCHES (int)(sizeof(astBenches) / sizeof(astBenches[0]))
+
+static int CompareDouble(const void *pvA, const void *pvB)
+{
+    double rA = *(const double *)pvA;
+    double rB = *(const double *)pvB;
+    return (rA > rB) - (rA < rB);
+}
+
+static void RunBench(const tStBench *pstBench, tStCorpus *pstCorpus, tStResult *pstResult)
+{
+    double arSamples[SAMPLES];
+    unsigned long ulOps = 0;
+
+    pstResult->rCalibNs = Calibrate();
+    PerfControl(PERF_EVENT_IOC_RESET);
+
+    // Warm up the caches and find how many passes fill one sample
+    double rStart = GetTimeNs();
+    unsigned long ulPassOps = pstBench->pfRun(pstCorpus);
+    double rPass = GetTimeNs() - rStart;
+    int iPasses = rPass > 0 && rPass < SAMPLE_NS ? (int)(SAMPLE_NS / rPass) : 1;
+
+    for (int s=0; s<SAMPLES; s++){
+        double rCalib = Calibrate();
+        pstResult->rCalibNs = rCalib < pstResult->rCalibNs ? rCalib : pstResult->rCalibNs;
+
+        PerfControl(PERF_EVENT_IOC_ENABLE); // Counts only the samples, not the reference loop
+        rStart = GetTimeNs();
+        for (int p=0; p<iPasses; p++){
+            pstBench->pfRun(pstCorpus);
+        }
+        arSamples[s] = (GetTimeNs() - rStart) / ((double)iPasses * ulPassOps);
+        ulOps += iPasses * ulPassOps;
+        PerfControl(PERF_EVENT_IOC_DISABLE);
+    }
+    PerfStop(pstResult->arPerOp, ulOps);
+
+    qsort(arSamples, SAMPLES, sizeof(double), CompareDouble);
+    pstResult->rNsPerOp = arSamples[SAMPLES/2];
+    pstResult->rMinNs = arSamples[0];
+    pstResult->rSpread = (arSamples[SAMPLES*3/4] - arSamples[SAMPLES/4]) / pstResult->rNsPerOp;
+    pstResult->ulOps = ulOps;
+}
+
+// One benchmark per line, as WriteJson writes them. The fastest sample is compared, interference from
+// other processes only ever makes a sample slower.
+static bool FindBaseline(const char *pcPath, const char *pcName, double *prMinNs, double *prCalibNs, double *prSpread)
+{
+    FILE *pFile = fopen(pcPath, "r");
+    char acLine[512];
+    char acPattern[96];
+    bool xFound = false;
+
+    if (pFile == NULL){
+        return false;
+    }
+    snprintf(acPattern, sizeof(acPattern), "\"name\": \"%s\"", pcName);
+    while (!xFound && fgets(acLine, sizeof(acLine), pFile) != NULL){
+        char *pcValue = strstr(acLine, "\"min_ns\": ");
+        if (strstr(acLine, acPattern) != NULL && pcValue != NULL){
+            char *pcCalib = strstr(acLine, "\"calibration_ns\": ");
+            char *pcSpread = strstr(acLine, "\"spread\": ");
+            *prMinNs = strtod(pcValue + strlen("\"min_ns\": "), NULL);
+            *prCalibNs = pcCalib != NULL ? strtod(pcCalib + strlen("\"calibration_ns\": "), NULL) : 0;
+            *prSpread = pcSpread != NULL ? strtod(pcSpread + strlen("\"spread\": "), NULL) : 0;
+            xFound = true;
+        }
+    }
+    fclose(pFile);
+    return xFound;
+}
+
+static void WriteJson(FILE *pFile, tStCorpus *pstCorpus, tStResult *astResults)
+{
+    fprintf(pFile, "{\n  \"positions\": %d,\n  \"cases\": %d,\n  \"samples\": %d,\n  \"perf\": %s,\n  \"benchmarks\": [\n", pstCorpus->iPositions, pstCorpus->iCases, SAMPLES, PerfAvailable() ? "true" : "false");
+    for (int b=0; b<NR_OF_BENCHES; b++){
+        tStResult *pstResult = &astResults[b];
+        fprintf(pFile, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns\": %.3f, \"spread\": %.4f, \"calibration_ns\": %.4f, \"ops\": %lu", astBenches[b].pcName, pstResult->rNsPerOp, pstResult->rMinNs, pstResult->rSpread, pstResult->rCalibNs, pstResult->ulOps);
+        for (int e=0; e<PERF_EVENTS; e++){
+            if (pstResult->arPerOp[e] < 0){
+                fprintf(pFile, ", \"%s\": null", apcPerfNames[e]);
+            } else{
+                fprintf(pFile, ", \"%s\": %.2f", apcPerfNames[e], pstResult->arPerOp[e]);
+            }
+        }
+        fprintf(pFile, "}%s\n", b+1 < NR_OF_BENCHES ? "," : "");
+    }
+    fprintf(pFile, "  ]\n}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int iPositions = 256;
+    const char *pcJson = NULL;
+    const char *pcBaseline = NULL;
+    double rThreshold = 10;
+    tStCorpus stCorpus;
+    tStResult astResults[NR_OF_BENCHES];
+    int iRegressions = 0;
+    int iNoisy = 0;
+
+    for (int a=1; a<argc; a++){
+        if (strcmp(argv[a], "--json") == 0 && a+1 < argc){
+            pcJson = argv[++a];
+        } else if (strcmp(argv[a], "--baseline") == 0 && a+1 < argc){
+            pcBaseline = argv[++a];
+        } else if (strcmp(argv[a], "--threshold") == 0 && a+1 < argc){
+            rThreshold = atof(argv[++a]);
+        } else{
+            iPositions = atoi(argv[a]) > 0 ? atoi(argv[a]) : iPositions;
+        }
+    }
+
+    RaceTableBuild();
+    BuildCorpus(&stCorpus, iPositions);
+    PerfOpen();
+
+    printf("%d positions, %d cases, hardware counters %s\n", stCorpus.iPositions, stCorpus.iCases, PerfAvailable() ? "on" : "not available");
+    printf("%-26s %10s %8s %10s %10s %s\n", "benchmark", "ns/op", "spread", "cycles/op", "instr/op", "vs baseline");
+    for (int b=0; b<NR_OF_BENCHES; b++){
+        double rBase = 0;
+        double rBaseCalib = 0;
+        double rBaseSpread = 0;
+        char acCompare[48] = "";
+
+        bool xBaseline = pcBaseline != NULL && FindBaseline(pcBaseline, astBenches[b].pcName, &rBase, &rBaseCalib, &rBaseSpread) && rBase > 0;
+        bool xNoisy = false;
+        bool xRegression = true;
+        double rChange = 0;
+
+        for (int t=0; t<ATTEMPTS && (xRegression || xNoisy); t++){
+            RunBench(&astBenches[b], &stCorpus, &astResults[b]);
+            if (xBaseline){
+                double rScale = rBaseCalib > 0 ? astResults[b].rCalibNs / rBaseCalib : 1; // Speed of this machine now against the baseline run
+                // A change within the noise of either run says nothing, such benchmarks are shown but not gated
+                double rSpread = (astResults[b].rSpread > rBaseSpread ? astResults[b].rSpread : rBaseSpread) * 100;
+                rChange = (astResults[b].rMinNs / (rBase * rScale) - 1) * 100;
+                xNoisy = rSpread >= rThreshold;
+            }
+            xRegression = xBaseline && !xNoisy && rChange > rThreshold;
+        }
+        if (xBaseline){
+            iRegressions += xRegression;
+            iNoisy += xNoisy;
+            snprintf(acCompare, sizeof(acCompare), "%+.1f%%%s", rChange, xNoisy ? " noisy, not gated" : xRegression ? " REGRESSION" : "");
+        }
+        printf("%-26s %10.2f %7.1f%%", astBenches[b].pcName, astResults[b].rNsPerOp, astResults[b].rSpread * 100);
+        for (int e=0; e<2; e++){
+            astResults[b].arPerOp[e] < 0 ? printf(" %10s", "-") : printf(" %10.1f", astResults[b].arPerOp[e]);
+        }
+        printf(" %s\n", acCompare);
+    }
+
+    if (pcJson != NULL){
+        FILE *pFile = strcmp(pcJson, "-") == 0 ? stdout : fopen(pcJson, "w");
+        if (pFile == NULL){
+            fprintf(stderr, "cannot write %s\n", pcJson);
+            return 2;
+        }
+        WriteJson(pFile, &stCorpus, astResults);
+        if (pFile != stdout){
+            fclose(pFile);
+        }
+    }
+
+    if (iNoisy > 0){
+        printf("%d benchmarks not gated, their spread is %.1f%% or more\n", iNoisy, rThreshold);
+    }
+    if (iRegressions > 0){
+        printf("%d benchmarks slower than the baseline by more than %.1f%%\n", iRegressions, rThreshold);
+    }
+
+    FreeCorpus(&stCorpus);
+    return iRegressions > 0;
+}
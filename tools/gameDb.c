@@ -0,0 +1,514 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "gameDb.h"
+
+#define ALIGN8(x) (((x) + 7) & ~(size_t)7)
+
+typedef struct tStDbWorker
+{
+    pthread_t stThread;
+    tStGame *stGame;
+    tPickPawn *apfPick;
+    tStDbBuilder *pstBuilder;
+} tStDbWorker;
+
+typedef struct tStDbWriter
+{
+    FILE *pFile;
+    pthread_mutex_t stLock;
+    pthread_cond_t stWritten;
+    unsigned int uiNextBlock; // Next block to simulate
+    unsigned int uiNextWrite; // Blocks are written in order, a finished block waits for its predecessors
+    unsigned int uiBlocks;
+    unsigned long long ulGames;
+    unsigned int uiFirstSeed;
+    unsigned long long *aulBlocks;
+    unsigned long long ulOffset;
+} tStDbWriter;
+
+static tStDbWriter stWriter;
+
+// Values up to 56 bits, the word read at the byte of the first bit has to hold all of them
+static void PutBits(unsigned char *pcBuf, size_t uiBit, unsigned long long uiValue, unsigned int uiBits)
+{
+    unsigned long long ulWord;
+
+    if (uiBits == 0){
+        return;
+    }
+    memcpy(&ulWord, pcBuf + uiBit/8, 8); // Columns have 8 bytes of slack at the end
+    ulWord |= uiValue << (uiBit%8);
+    memcpy(pcBuf + uiBit/8, &ulWord, 8);
+}
+
+static unsigned long long GetBits(const unsigned char *pcBuf, size_t uiBit, unsigned int uiBits)
+{
+    unsigned long long ulWord;
+
+    if (uiBits == 0){
+        return 0;
+    }
+    memcpy(&ulWord, pcBuf + uiBit/8, 8);
+    return (ulWord >> (uiBit%8)) & ((1ULL << uiBits) - 1);
+}
+
+static unsigned int GetWidth(unsigned long long uiValue)
+{
+    unsigned int uiBits = 0;
+
+    while (uiValue >> uiBits){
+        uiBits++;
+    }
+
+    return uiBits;
+}
+
+static size_t GetColumnSize(size_t uiCount, unsigned int uiBits)
+{
+    return ALIGN8((uiCount*uiBits + 7)/8 + 8);
+}
+
+void DbBuilderReset(tStDbBuilder *pstBuilder)
+{
+    pstBuilder->uiGames = 0;
+    pstBuilder->uiNrOfThrows = 0;
+    pstBuilder->uiEntries = 0;
+}
+
+void DbBuilderFree(tStDbBuilder *pstBuilder)
+{
+    free(pstBuilder->auiMove);
+    free(pstBuilder->aulHash);
+    free(pstBuilder->auiHashGame);
+}
+
+static void AddThrow(tStDbBuilder *pstBuilder, unsigned char uiMove)
+{
+    if (pstBuilder->uiNrOfThrows == pstBuilder->uiThrowCapacity){
+        pstBuilder->uiThrowCapacity = pstBuilder->uiThrowCapacity ? pstBuilder->uiThrowCapacity*2 : 1 << 20;
+        pstBuilder->auiMove = realloc(pstBuilder->auiMove, pstBuilder->uiThrowCapacity);
+    }
+    pstBuilder->auiMove[pstBuilder->uiNrOfThrows] = uiMove;
+    pstBuilder->uiNrOfThrows++;
+}
+
+static void AddEntry(tStDbBuilder *pstBuilder, unsigned long long ulHash, size_t uiGameStart)
+{
+    for (size_t k=uiGameStart; k<pstBuilder->uiEntries; k++){ // Positions often repeat while nobody throws a 6
+        if (pstBuilder->aulHash[k] == ulHash){
+            return;
+        }
+    }
+
+    if (pstBuilder->uiEntries == pstBuilder->uiEntryCapacity){
+        pstBuilder->uiEntryCapacity = pstBuilder->uiEntryCapacity ? pstBuilder->uiEntryCapacity*2 : 1 << 16;
+        pstBuilder->aulHash = realloc(pstBuilder->aulHash, pstBuilder->uiEntryCapacity * sizeof(unsigned long long));
+        pstBuilder->auiHashGame = realloc(pstBuilder->auiHashGame, pstBuilder->uiEntryCapacity * sizeof(unsigned short));
+    }
+    pstBuilder->aulHash[pstBuilder->uiEntries] = ulHash;
+    pstBuilder->auiHashGame[pstBuilder->uiEntries] = pstBuilder->uiGames;
+    pstBuilder->uiEntries++;
+}
+
+void DbPlayGame(tStDbBuilder *pstBuilder, tStGame *stGame, unsigned int uiSeed, tPickPawn *apfPick)
+{
+    size_t uiFirstThrow = pstBuilder->uiNrOfThrows;
+    size_t uiFirstEntry = pstBuilder->uiEntries;
+    unsigned char uiWinner = 0;
+    tStTurnLog stLog;
+
+    BoardInitializer(stGame);
+    stGame->eTurn = PlayerOne;
+    SeedDice(stGame, uiSeed);
+    AddEntry(pstBuilder, HashBoard(stGame), uiFirstEntry);
+
+    for (int t=0; t<DB_MAX_TURNS; t++){
+        bool xWon = PlayTurnLogged(stGame, apfPick[stGame->eTurn/POFF], &stLog);
+        if (stLog.uiThrows > TURN_LOG_SIZE){ // Turn cannot be replayed, keep the game up to here
+            break;
+        }
+
+        for (int k=0; k<stLog.uiThrows; k++){
+            AddThrow(pstBuilder, stLog.auiMove[k]);
+        }
+
+        if (xWon){
+            uiWinner = stGame->eTurn/POFF;
+            AddEntry(pstBuilder, HashBoard(stGame), uiFirstEntry); // The replay keeps the winner on turn
+            break;
+        }
+        SwitchPlayer(stGame);
+        AddEntry(pstBuilder, HashBoard(stGame), uiFirstEntry);
+    }
+
+    pstBuilder->auiSeed[pstBuilder->uiGames] = uiSeed;
+    pstBuilder->auiWinner[pstBuilder->uiGames] = uiWinner;
+    pstBuilder->auiThrows[pstBuilder->uiGames] = pstBuilder->uiNrOfThrows - uiFirstThrow;
+    pstBuilder->uiGames++;
+}
+
+typedef struct tStDbEntry
+{
+    unsigned long long ulHash; // Leading DB_HASH_BITS of the position hash
+    unsigned short uiGame;
+} tStDbEntry;
+
+static int CompareEntries(const void *pvA, const void *pvB)
+{
+    const tStDbEntry *pstA = pvA;
+    const tStDbEntry *pstB = pvB;
+
+    if (pstA->ulHash != pstB->ulHash){
+        return pstA->ulHash < pstB->ulHash ? -1 : 1;
+    }
+    return (int)pstA->uiGame - (int)pstB->uiGame;
+}
+
+size_t DbEncodeBlock(tStDbBuilder *pstBuilder, unsigned char **ppcBlock)
+{
+    tStDbBlockHeader stHeader = {0};
+    unsigned int auiZigzag[DB_BLOCK_GAMES];
+    unsigned int uiMaxDelta = 0;
+    unsigned int uiMaxThrows = 0;
+    unsigned long long ulMaxDelta = 0;
+
+    stHeader.uiGames = pstBuilder->uiGames;
+    stHeader.uiThrows = pstBuilder->uiNrOfThrows;
+    stHeader.uiEntries = pstBuilder->uiEntries;
+    stHeader.uiFirstSeed = pstBuilder->auiSeed[0];
+
+    // Delta of the seeds, mapped to unsigned so small steps in both directions stay small
+    for (unsigned int g=0; g<pstBuilder->uiGames; g++){
+        int iDelta = g > 0 ? (int)(pstBuilder->auiSeed[g] - pstBuilder->auiSeed[g-1]) : 0;
+        auiZigzag[g] = ((unsigned int)iDelta << 1) ^ (unsigned int)(iDelta >> 31);
+        uiMaxDelta = auiZigzag[g] > uiMaxDelta ? auiZigzag[g] : uiMaxDelta;
+        uiMaxThrows = pstBuilder->auiThrows[g] > uiMaxThrows ? pstBuilder->auiThrows[g] : uiMaxThrows;
+    }
+    stHeader.uiSeedBits = GetWidth(uiMaxDelta);
+    stHeader.uiThrowBits = GetWidth(uiMaxThrows);
+
+    // Index sorted by hash, games with the same hash stay in ascending order. Sorted hashes lie close
+    // together, so their deltas need far fewer bits than the hashes.
+    tStDbEntry *astEntries = malloc(stHeader.uiEntries * sizeof(tStDbEntry) + 1);
+    for (unsigned int k=0; k<stHeader.uiEntries; k++){
+        astEntries[k].ulHash = pstBuilder->aulHash[k] >> (64 - DB_HASH_BITS);
+        astEntries[k].uiGame = pstBuilder->auiHashGame[k];
+    }
+    qsort(astEntries, stHeader.uiEntries, sizeof(tStDbEntry), CompareEntries);
+    for (unsigned int k=1; k<stHeader.uiEntries; k++){
+        unsigned long long ulDelta = k % DB_INDEX_STRIDE ? astEntries[k].ulHash - astEntries[k-1].ulHash : 0;
+        ulMaxDelta = ulDelta > ulMaxDelta ? ulDelta : ulMaxDelta;
+    }
+    stHeader.uiDeltaBits = GetWidth(ulMaxDelta);
+    stHeader.uiGameBits = GetWidth(stHeader.uiGames > 1 ? stHeader.uiGames - 1 : 0);
+    unsigned int uiSamples = (stHeader.uiEntries + DB_INDEX_STRIDE - 1) / DB_INDEX_STRIDE;
+
+    size_t auiSize[DbColumns] = {
+        GetColumnSize(stHeader.uiGames, stHeader.uiSeedBits),
+        GetColumnSize(stHeader.uiGames, 3),
+        GetColumnSize(stHeader.uiGames, stHeader.uiThrowBits),
+        GetColumnSize(stHeader.uiThrows, 3),
+        ALIGN8(uiSamples * sizeof(unsigned long long)),
+        GetColumnSize(stHeader.uiEntries, stHeader.uiDeltaBits),
+        GetColumnSize(stHeader.uiEntries, stHeader.uiGameBits)
+    };
+    size_t uiOffset = ALIGN8(sizeof(tStDbBlockHeader));
+    for (int c=0; c<DbColumns; c++){
+        stHeader.auiColumn[c] = uiOffset;
+        uiOffset += auiSize[c];
+    }
+    stHeader.auiColumn[DbColumns] = uiOffset;
+
+    unsigned char *pcBlock = calloc(1, uiOffset);
+    memcpy(pcBlock, &stHeader, sizeof(stHeader));
+
+    for (unsigned int g=0; g<stHeader.uiGames; g++){
+        PutBits(pcBlock + stHeader.auiColumn[DbSeed], (size_t)g*stHeader.uiSeedBits, auiZigzag[g], stHeader.uiSeedBits);
+        PutBits(pcBlock + stHeader.auiColumn[DbWinner], (size_t)g*3, pstBuilder->auiWinner[g], 3);
+        PutBits(pcBlock + stHeader.auiColumn[DbThrows], (size_t)g*stHeader.uiThrowBits, pstBuilder->auiThrows[g], stHeader.uiThrowBits);
+    }
+    for (size_t k=0; k<stHeader.uiThrows; k++){
+        PutBits(pcBlock + stHeader.auiColumn[DbMove], k*3, pstBuilder->auiMove[k], 3);
+    }
+
+    unsigned long long *aulSamples = (unsigned long long *)(pcBlock + stHeader.auiColumn[DbIndexSample]);
+    for (unsigned int k=0; k<stHeader.uiEntries; k++){
+        if (k % DB_INDEX_STRIDE == 0){
+            aulSamples[k / DB_INDEX_STRIDE] = astEntries[k].ulHash;
+        } else{
+            PutBits(pcBlock + stHeader.auiColumn[DbIndexHash], (size_t)k*stHeader.uiDeltaBits, astEntries[k].ulHash - astEntries[k-1].ulHash, stHeader.uiDeltaBits);
+        }
+        PutBits(pcBlock + stHeader.auiColumn[DbIndexGame], (size_t)k*stHeader.uiGameBits, astEntries[k].uiGame, stHeader.uiGameBits);
+    }
+    free(astEntries);
+
+    *ppcBlock = pcBlock;
+    return uiOffset;
+}
+
+static void *DbWorker(void *pvArg)
+{
+    tStDbWorker *pstWorker = pvArg;
+
+    pthread_mutex_lock(&stWriter.stLock);
+    while (stWriter.uiNextBlock < stWriter.uiBlocks){
+        unsigned int uiBlock = stWriter.uiNextBlock++;
+        unsigned long long ulFirst = (unsigned long long)uiBlock * DB_BLOCK_GAMES;
+        unsigned long long ulLast = ulFirst + DB_BLOCK_GAMES < stWriter.ulGames ? ulFirst + DB_BLOCK_GAMES : stWriter.ulGames;
+        pthread_mutex_unlock(&stWriter.stLock);
+
+        // Simulate and encode without the lock, only the file write is serialised
+        unsigned char *pcBlock;
+        DbBuilderReset(pstWorker->pstBuilder);
+        for (unsigned long long g=ulFirst; g<ulLast; g++){
+            DbPlayGame(pstWorker->pstBuilder, pstWorker->stGame, stWriter.uiFirstSeed + g, pstWorker->apfPick);
+        }
+        size_t uiSize = DbEncodeBlock(pstWorker->pstBuilder, &pcBlock);
+
+        pthread_mutex_lock(&stWriter.stLock);
+        while (stWriter.uiNextWrite != uiBlock){
+            pthread_cond_wait(&stWriter.stWritten, &stWriter.stLock);
+        }
+        fwrite(pcBlock, 1, uiSize, stWriter.pFile);
+        stWriter.aulBlocks[uiBlock] = stWriter.ulOffset;
+        stWriter.ulOffset += uiSize;
+        stWriter.uiNextWrite++;
+        pthread_cond_broadcast(&stWriter.stWritten);
+        free(pcBlock);
+    }
+    pthread_mutex_unlock(&stWriter.stLock);
+
+    return NULL;
+}
+
+int DbWrite(const char *pcPath, unsigned long long ulGames, unsigned int uiFirstSeed, int iThreads, tStGame *astGames, tPickPawn *apfPick)
+{
+    tStDbFileHeader stHeader = {DB_MAGIC, 0, ulGames, 0};
+    tStDbWorker *astWorkers = calloc(iThreads, sizeof(tStDbWorker));
+
+    stWriter.pFile = fopen(pcPath, "wb");
+    if (stWriter.pFile == NULL){
+        free(astWorkers);
+        return -1;
+    }
+    stWriter.uiBlocks = (ulGames + DB_BLOCK_GAMES - 1) / DB_BLOCK_GAMES;
+    stWriter.uiNextBlock = 0;
+    stWriter.uiNextWrite = 0;
+    stWriter.ulGames = ulGames;
+    stWriter.uiFirstSeed = uiFirstSeed;
+    stWriter.aulBlocks = malloc(stWriter.uiBlocks * sizeof(unsigned long long) + 1);
+    stWriter.ulOffset = ALIGN8(sizeof(stHeader));
+    pthread_mutex_init(&stWriter.stLock, NULL);
+    pthread_cond_init(&stWriter.stWritten, NULL);
+    fwrite(&stHeader, 1, stWriter.ulOffset, stWriter.pFile); // Rewritten once the directory is known
+
+    // Every thread plays on its own board, the boards are constructed by the caller
+    for (int t=0; t<iThreads; t++){
+        astWorkers[t].stGame = &astGames[t];
+        astWorkers[t].apfPick = apfPick;
+        astWorkers[t].pstBuilder = calloc(1, sizeof(tStDbBuilder));
+        pthread_create(&astWorkers[t].stThread, NULL, DbWorker, &astWorkers[t]);
+    }
+    for (int t=0; t<iThreads; t++){
+        pthread_join(astWorkers[t].stThread, NULL);
+        DbBuilderFree(astWorkers[t].pstBuilder);
+        free(astWorkers[t].pstBuilder);
+    }
+
+    stHeader.uiBlocks = stWriter.uiBlocks;
+    stHeader.ulDirectory = stWriter.ulOffset;
+    fwrite(stWriter.aulBlocks, sizeof(unsigned long long), stWriter.uiBlocks, stWriter.pFile);
+    fseek(stWriter.pFile, 0, SEEK_SET);
+    fwrite(&stHeader, 1, sizeof(stHeader), stWriter.pFile);
+    fclose(stWriter.pFile);
+
+    pthread_mutex_destroy(&stWriter.stLock);
+    pthread_cond_destroy(&stWriter.stWritten);
+    free(stWriter.aulBlocks);
+    free(astWorkers);
+    return 0;
+}
+
+int DbOpen(tStDb *pstDb, const char *pcPath)
+{
+    struct stat stStat;
+    int iFile = open(pcPath, O_RDONLY);
+
+    if (iFile < 0 || fstat(iFile, &stStat) != 0 || (size_t)stStat.st_size < sizeof(tStDbFileHeader)){
+        if (iFile >= 0){
+            close(iFile);
+        }
+        return -1;
+    }
+
+    pstDb->uiSize = stStat.st_size;
+    pstDb->pcData = mmap(NULL, pstDb->uiSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+    close(iFile);
+    if (pstDb->pcData == MAP_FAILED){
+        return -1;
+    }
+
+    pstDb->pstHeader = (const tStDbFileHeader *)pstDb->pcData;
+    if (pstDb->pstHeader->uiMagic != DB_MAGIC || pstDb->pstHeader->ulDirectory + pstDb->pstHeader->uiBlocks * sizeof(unsigned long long) > pstDb->uiSize){
+        munmap((void *)pstDb->pcData, pstDb->uiSize);
+        return -1;
+    }
+    pstDb->aulBlocks = (const unsigned long long *)(pstDb->pcData + pstDb->pstHeader->ulDirectory);
+
+    return 0;
+}
+
+void DbClose(tStDb *pstDb)
+{
+    munmap((void *)pstDb->pcData, pstDb->uiSize);
+}
+
+static const tStDbBlockHeader *GetBlock(tStDb *pstDb, unsigned int uiBlock)
+{
+    return (const tStDbBlockHeader *)(pstDb->pcData + pstDb->aulBlocks[uiBlock]);
+}
+
+static const unsigned char *GetColumn(const tStDbBlockHeader *pstBlock, tEnumDbColumn eColumn)
+{
+    return (const unsigned char *)pstBlock + pstBlock->auiColumn[eColumn];
+}
+
+size_t DbColumnBytes(tStDb *pstDb, tEnumDbColumn eColumn)
+{
+    size_t uiBytes = 0;
+
+    for (unsigned int b=0; b<pstDb->pstHeader->uiBlocks; b++){
+        const tStDbBlockHeader *pstBlock = GetBlock(pstDb, b);
+        uiBytes += pstBlock->auiColumn[eColumn+1] - pstBlock->auiColumn[eColumn];
+    }
+
+    return uiBytes;
+}
+
+unsigned int DbGameSeed(tStDb *pstDb, unsigned long long ulGame)
+{
+    const tStDbBlockHeader *pstBlock = GetBlock(pstDb, ulGame / DB_BLOCK_GAMES);
+    unsigned int uiSeed = pstBlock->uiFirstSeed;
+
+    for (unsigned int g=1; g<=ulGame % DB_BLOCK_GAMES; g++){
+        unsigned int uiZigzag = GetBits(GetColumn(pstBlock, DbSeed), (size_t)g*pstBlock->uiSeedBits, pstBlock->uiSeedBits);
+        uiSeed += (uiZigzag >> 1) ^ -(uiZigzag & 1);
+    }
+
+    return uiSeed;
+}
+
+unsigned char DbGameWinner(tStDb *pstDb, unsigned long long ulGame)
+{
+    const tStDbBlockHeader *pstBlock = GetBlock(pstDb, ulGame / DB_BLOCK_GAMES);
+    return GetBits(GetColumn(pstBlock, DbWinner), (ulGame % DB_BLOCK_GAMES)*3, 3);
+}
+
+static unsigned long long ReplayGame(tStDb *pstDb, unsigned long long ulGame, tStGame *stGame, unsigned int uiTurns, unsigned long long ulFind, bool *pxFound)
+{
+    const tStDbBlockHeader *pstBlock = GetBlock(pstDb, ulGame / DB_BLOCK_GAMES);
+    const unsigned char *pcThrows = GetColumn(pstBlock, DbThrows);
+    unsigned int uiGame = ulGame % DB_BLOCK_GAMES;
+    size_t uiFirst = 0;
+    unsigned long long ulTurns = 0;
+
+    for (unsigned int g=0; g<uiGame; g++){
+        uiFirst += GetBits(pcThrows, (size_t)g*pstBlock->uiThrowBits, pstBlock->uiThrowBits);
+    }
+    size_t uiLast = uiFirst + GetBits(pcThrows, (size_t)uiGame*pstBlock->uiThrowBits, pstBlock->uiThrowBits);
+
+    BoardInitializer(stGame);
+    stGame->eTurn = PlayerOne;
+    SeedDice(stGame, DbGameSeed(pstDb, ulGame)); // Picks do not roll, so every throw of the game takes the next dice of the seed
+    *pxFound = HashBoard(stGame) == ulFind;
+
+    tEnumReplay eReplay = ReplayNext;
+    for (size_t k=uiFirst; k<uiLast && ulTurns<uiTurns && !*pxFound && eReplay != ReplayInvalid; k++){ // An invalid move means a damaged file
+        eReplay = ReplayThrow(stGame, RollDice(stGame), GetBits(GetColumn(pstBlock, DbMove), k*3, 3));
+        if (eReplay == ReplayTurnOver){
+            ulTurns++;
+            if (k+1 < uiLast){ // Keep the winner as player on turn after the last throw
+                SwitchPlayer(stGame);
+                *pxFound = HashBoard(stGame) == ulFind;
+            }
+        }
+    }
+
+    return ulTurns;
+}
+
+unsigned long long DbReplay(tStDb *pstDb, unsigned long long ulGame, tStGame *stGame, unsigned int uiTurns)
+{
+    bool xFound;
+    return ReplayGame(pstDb, ulGame, stGame, uiTurns, 0, &xFound);
+}
+
+unsigned long long DbQuery(tStDb *pstDb, unsigned long long ulHash, unsigned int *auiWins, unsigned long long *aulGames, size_t uiMaxGames)
+{
+    unsigned long long ulCount = 0;
+
+    memset(auiWins, 0, 5*sizeof(unsigned int));
+
+    ulHash >>= 64 - DB_HASH_BITS;
+
+    // Every block has its own sorted index. A binary search over the samples finds the first sample not
+    // below the hash, the matches start in the sample range before it at the earliest.
+    for (unsigned int b=0; b<pstDb->pstHeader->uiBlocks; b++){
+        const tStDbBlockHeader *pstBlock = GetBlock(pstDb, b);
+        const unsigned long long *aulSamples = (const unsigned long long *)GetColumn(pstBlock, DbIndexSample);
+        const unsigned char *pcDeltas = GetColumn(pstBlock, DbIndexHash);
+        const unsigned char *pcGames = GetColumn(pstBlock, DbIndexGame);
+        unsigned int uiLow = 0;
+        unsigned int uiHigh = (pstBlock->uiEntries + DB_INDEX_STRIDE - 1) / DB_INDEX_STRIDE;
+
+        while (uiLow < uiHigh){
+            unsigned int uiMid = (uiLow + uiHigh) / 2;
+            if (aulSamples[uiMid] < ulHash){
+                uiLow = uiMid + 1;
+            } else{
+                uiHigh = uiMid;
+            }
+        }
+
+        unsigned long long ulEntry = 0;
+        for (unsigned int k=(uiLow > 0 ? uiLow-1 : 0)*DB_INDEX_STRIDE; k<pstBlock->uiEntries && ulEntry <= ulHash; k++){
+            ulEntry = k % DB_INDEX_STRIDE ? ulEntry + GetBits(pcDeltas, (size_t)k*pstBlock->uiDeltaBits, pstBlock->uiDeltaBits) : aulSamples[k / DB_INDEX_STRIDE];
+            if (ulEntry == ulHash){
+                unsigned int uiGame = GetBits(pcGames, (size_t)k*pstBlock->uiGameBits, pstBlock->uiGameBits);
+                auiWins[GetBits(GetColumn(pstBlock, DbWinner), uiGame*3, 3)]++;
+                if (ulCount < uiMaxGames){
+                    aulGames[ulCount] = (unsigned long long)b * DB_BLOCK_GAMES + uiGame;
+                }
+                ulCount++;
+            }
+        }
+    }
+
+    return ulCount;
+}
+
+unsigned long long DbScan(tStDb *pstDb, tStGame *stGame, unsigned long long ulHash, unsigned int uiTurns, unsigned int *auiWins)
+{
+    unsigned long long ulCount = 0;
+
+    memset(auiWins, 0, 5*sizeof(unsigned int));
+
+    // Replays every game without the index, used to check it
+    for (unsigned long long g=0; g<pstDb->pstHeader->ulGames; g++){
+        bool xFound;
+        ReplayGame(pstDb, g, stGame, uiTurns, ulHash, &xFound);
+        if (xFound){
+            auiWins[DbGameWinner(pstDb, g)]++;
+            ulCount++;
+        }
+    }
+
+    return ulCount;
+}
@@ -0,0 +1,84 @@
+#ifndef GAMEDB_H
+#define GAMEDB_H
+
+#include <stddef.h>
+#include "gameRules.h"
+
+#define DB_MAGIC 0x3342446E // "nDB3"
+#define DB_BLOCK_GAMES 4096 // Games per block, every block has its own columns and an index of every position of its games
+#define DB_MAX_TURNS 4000 // Games without a winner after this many turns are stored with winner 0
+#define DB_HASH_BITS 48 // Leading bits of the position hash kept in the index, a foreign game matches once in about 2^48 / entries queries
+#define DB_INDEX_STRIDE 64 // Index entries per directory sample
+
+typedef enum tEnumDbColumn
+{
+    DbSeed, // Zigzag delta to the previous seed, bit-packed
+    DbWinner, // Player/POFF, 0 when the game was stopped
+    DbThrows, // Throws per game, bit-packed
+    DbMove, // 3 bits per throw, see MOVE_ codes in gameRules.h. The dice are not stored, RollDice repeats them from the seed
+    DbIndexSample, // Every DB_INDEX_STRIDE-th hash of the index, searched first
+    DbIndexHash, // Sorted hashes as deltas to the entry before, 0 where a sample starts, bit-packed
+    DbIndexGame, // Game within the block per hash, bit-packed
+    DbColumns
+} tEnumDbColumn;
+
+typedef struct tStDbFileHeader
+{
+    unsigned int uiMagic;
+    unsigned int uiBlocks;
+    unsigned long long ulGames;
+    unsigned long long ulDirectory; // File offset of the block offsets
+} tStDbFileHeader;
+
+typedef struct tStDbBlockHeader
+{
+    unsigned int uiGames;
+    unsigned int uiThrows;
+    unsigned int uiEntries; // Index entries
+    unsigned int uiFirstSeed;
+    unsigned char uiSeedBits;
+    unsigned char uiThrowBits;
+    unsigned char uiDeltaBits;
+    unsigned char uiGameBits;
+    unsigned int auiColumn[DbColumns+1]; // Offset of every column from the block start, the last one is the block size
+} tStDbBlockHeader;
+
+typedef struct tStDbBuilder
+{
+    unsigned int uiGames;
+    unsigned int auiSeed[DB_BLOCK_GAMES];
+    unsigned char auiWinner[DB_BLOCK_GAMES];
+    unsigned int auiThrows[DB_BLOCK_GAMES];
+    unsigned char *auiMove;
+    size_t uiNrOfThrows;
+    size_t uiThrowCapacity;
+    unsigned long long *aulHash;
+    unsigned short *auiHashGame;
+    size_t uiEntries;
+    size_t uiEntryCapacity;
+} tStDbBuilder;
+
+typedef struct tStDb
+{
+    const unsigned char *pcData; // Memory mapped file
+    size_t uiSize;
+    const tStDbFileHeader *pstHeader;
+    const unsigned long long *aulBlocks; // Offset of every block
+} tStDb;
+
+void DbBuilderReset(tStDbBuilder *pstBuilder);
+void DbBuilderFree(tStDbBuilder *pstBuilder);
+void DbPlayGame(tStDbBuilder *pstBuilder, tStGame *stGame, unsigned int uiSeed, tPickPawn *apfPick);
+size_t DbEncodeBlock(tStDbBuilder *pstBuilder, unsigned char **ppcBlock);
+int DbWrite(const char *pcPath, unsigned long long ulGames, unsigned int uiFirstSeed, int iThreads, tStGame *astGames, tPickPawn *apfPick);
+
+int DbOpen(tStDb *pstDb, const char *pcPath);
+void DbClose(tStDb *pstDb);
+size_t DbColumnBytes(tStDb *pstDb, tEnumDbColumn eColumn);
+unsigned int DbGameSeed(tStDb *pstDb, unsigned long long ulGame);
+unsigned char DbGameWinner(tStDb *pstDb, unsigned long long ulGame);
+unsigned long long DbReplay(tStDb *pstDb, unsigned long long ulGame, tStGame *stGame, unsigned int uiTurns);
+unsigned long long DbQuery(tStDb *pstDb, unsigned long long ulHash, unsigned int *auiWins, unsigned long long *aulGames, size_t uiMaxGames);
+unsigned long long DbScan(tStDb *pstDb, tStGame *stGame, unsigned long long ulHash, unsigned int uiTurns, unsigned int *auiWins);
+
+#endif
@@ -0,0 +1,110 @@
+// Fills a game database with self-play games and measures ingest rate, size and query latency
+// Build: gcc -O2 -pthread -Isrc -Itools -o gameDbBench tools/gameDbBench.c tools/gameDb.c src/gameRules.c src/raceTable.c src/evaluator.c src/memTrack.c -lm
+// Usage: ./gameDbBench [file] [games] [threads] [queries]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gameDb.h"
+#include "evaluator.h"
+
+#define SCAN_QUERIES 3 // Queries which are repeated with a full scan to check the index
+#define MAX_THREADS 64
+
+static double GetTimeUs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1e6 + stTime.tv_nsec / 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pcPath = argc > 1 ? argv[1] : "games.db";
+    unsigned long long ulGames = argc > 2 ? strtoull(argv[2], NULL, 10) : 100000;
+    int iThreads = argc > 3 ? atoi(argv[3]) : 4;
+    int iQueries = argc > 4 ? atoi(argv[4]) : 1000;
+    tPickPawn apfPick[5] = {NULL, PickPawnEvaluator, PickPawnComputer, PickPawnEvaluator, PickPawnComputer};
+    static tStGame astGames[MAX_THREADS];
+    static unsigned long long aulGames[1];
+    static const char *apcColumns[DbColumns] = {"seed", "winner", "throws", "move", "index sample", "index hash", "index game"};
+    tStDb stDb;
+
+    iThreads = iThreads < 1 ? 1 : (iThreads > MAX_THREADS ? MAX_THREADS : iThreads);
+    for (int t=0; t<iThreads; t++){
+        astGames[t].uiFieldHeight = FIELD_SIZE;
+        astGames[t].uiFieldWidth = FIELD_SIZE;
+        BoardConstructor(&astGames[t]);
+    }
+    RaceTableBuild();
+    EvaluatorInit(&astGames[0]);
+
+    double rStart = GetTimeUs();
+    if (DbWrite(pcPath, ulGames, 1, iThreads, astGames, apfPick) != 0 || DbOpen(&stDb, pcPath) != 0){
+        fprintf(stderr, "cannot write %s\n", pcPath);
+        return 1;
+    }
+    double rIngest = GetTimeUs() - rStart;
+
+    printf("games\t\t\t%llu in %u blocks\n", ulGames, stDb.pstHeader->uiBlocks);
+    printf("ingest\t\t\t%.0f games/s with %d threads\n", ulGames * 1e6 / rIngest, iThreads);
+    printf("file\t\t\t%zu bytes, %.1f bytes/game\n", stDb.uiSize, (double)stDb.uiSize / ulGames);
+    for (int c=0; c<DbColumns; c++){
+        printf("  %-12s\t\t%.2f bytes/game\n", apcColumns[c], (double)DbColumnBytes(&stDb, c) / ulGames);
+    }
+
+    // Replayed games have to end with the stored winner
+    unsigned int uiBadReplays = 0;
+    unsigned int uiReplays = 0;
+    unsigned long long ulTurns = 0;
+    unsigned long long ulMaxTurns = 0;
+    for (unsigned long long g=0; g<ulGames; g+=ulGames/100+1){
+        unsigned long long ulGameTurns = DbReplay(&stDb, g, &astGames[0], DB_MAX_TURNS);
+        unsigned char uiWinner = DbGameWinner(&stDb, g);
+        uiBadReplays += uiWinner != 0 && (!CheckWinner(&astGames[0]) || astGames[0].eTurn/POFF != uiWinner);
+        uiReplays++;
+        ulTurns += ulGameTurns;
+        ulMaxTurns = ulGameTurns > ulMaxTurns ? ulGameTurns : ulMaxTurns;
+    }
+    printf("replay mismatches\t%u\n", uiBadReplays);
+    printf("turns per game\t\tmean %.0f, max %llu\n", (double)ulTurns / uiReplays, ulMaxTurns);
+
+    // Query positions at any depth of random games, the game itself has to be found
+    double rTotal = 0;
+    double rWorst = 0;
+    unsigned long long ulMatches = 0;
+    unsigned int uiMissing = 0;
+    unsigned int auiWins[5];
+    srand(1);
+    for (int q=0; q<iQueries; q++){
+        unsigned long long ulGame = ((unsigned long long)rand() * RAND_MAX + rand()) % ulGames;
+        unsigned long long ulGameTurns = DbReplay(&stDb, ulGame, &astGames[0], DB_MAX_TURNS);
+        DbReplay(&stDb, ulGame, &astGames[0], rand() % (ulGameTurns+1));
+        unsigned long long ulHash = HashBoard(&astGames[0]);
+
+        rStart = GetTimeUs();
+        unsigned long long ulCount = DbQuery(&stDb, ulHash, auiWins, aulGames, 0);
+        double rTime = GetTimeUs() - rStart;
+        rTotal += rTime;
+        rWorst = rTime > rWorst ? rTime : rWorst;
+        ulMatches += ulCount;
+        uiMissing += ulCount == 0;
+
+        if (q < SCAN_QUERIES){
+            unsigned int auiScanWins[5];
+            rStart = GetTimeUs();
+            unsigned long long ulScan = DbScan(&stDb, &astGames[1 % iThreads], ulHash, DB_MAX_TURNS, auiScanWins);
+            printf("query %d\t\t\t%llu games (P1 %u P2 %u P3 %u P4 %u), index %.0f us, scan %llu games in %.0f us\n", q, ulCount, auiWins[1], auiWins[2], auiWins[3], auiWins[4], rTime, ulScan, GetTimeUs() - rStart);
+        }
+    }
+    if (iQueries > 0){
+        printf("queries\t\t\t%d, mean %.1f us, worst %.1f us, %.1f games per query, %u without the source game\n", iQueries, rTotal / iQueries, rWorst, (double)ulMatches / iQueries, uiMissing);
+    }
+
+    DbClose(&stDb);
+    for (int t=0; t<iThreads; t++){
+        BoardDestructor(&astGames[t]);
+    }
+    return 0;
+}
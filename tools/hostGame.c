@@ -0,0 +1,197 @@
+// Runs the game itself on a host with a scripted player and prints the debug overlay of the last frame
+// Build: gcc -O2 -Isrc -Itools/hostStubs -o hostGame tools/hostGame.c src/MaDn.c src/inputHandler.c src/gameRules.c src/raceTable.c src/evaluator.c src/history.c src/memTrack.c src/renderList.c src/winMeter.c src/strategy.c src/task.c -lm -ldl
+// Usage: HOST_FRAMES=100000 ./hostGame, the Vita SDK calls are answered by the stand-ins in tools/hostStubs
+// The player touches a random field every other frame, which throws the dice and picks pawns, and presses
+// Circle every 20 frames to start a new game after a win. Start shows the overlay, Select ends the run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vita2d.h>
+#include <vitasdk.h>
+#include <psp2/ctrl.h>
+#include <psp2/touch.h>
+#include <psp2/kernel/processmgr.h>
+#include <psp2/kernel/sysmem.h>
+#include <psp2/gxm.h>
+
+#include "gameRules.h"
+
+#define POOL_SIZE (1 << 22) // vita2d hands out vertex memory per frame
+#define MAX_TEXTS 16
+#define TEXT_LENGTH 64
+
+struct vita2d_pgf
+{
+    int iUnused;
+};
+
+static vita2d_pgf stFont;
+static unsigned char acPool[POOL_SIZE];
+static size_t uiPool = 0;
+static void *pvBlock = NULL;
+static unsigned int uiFrame = 0;
+static unsigned int uiFrames = 100000;
+static unsigned int uiRand = 7;
+static char aacTexts[MAX_TEXTS][TEXT_LENGTH]; // Text drawn in the current frame
+static unsigned short uiNrOfTexts = 0;
+static unsigned long long ulStartUs;
+
+static unsigned int Rand()
+{
+    uiRand ^= uiRand << 13;
+    uiRand ^= uiRand >> 17;
+    uiRand ^= uiRand << 5;
+    return uiRand;
+}
+
+unsigned long long sceKernelGetProcessTimeWide(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1000000ULL + stTime.tv_nsec / 1000;
+}
+
+int vita2d_init(void)
+{
+    const char *pcFrames = getenv("HOST_FRAMES");
+
+    uiFrames = pcFrames != NULL ? strtoul(pcFrames, NULL, 10) : uiFrames;
+    ulStartUs = sceKernelGetProcessTimeWide();
+    return 0;
+}
+
+void vita2d_start_drawing(void)
+{
+    uiPool = 0;
+    uiNrOfTexts = 0;
+    uiFrame++;
+}
+
+void vita2d_end_drawing(void){}
+void vita2d_clear_screen(void){}
+void vita2d_swap_buffers(void){}
+void vita2d_wait_rendering_done(void){}
+void vita2d_draw_rectangle(float x, float y, float w, float h, unsigned int color){ (void)x; (void)y; (void)w; (void)h; (void)color; }
+void vita2d_draw_fill_circle(float x, float y, float radius, unsigned int color){ (void)x; (void)y; (void)radius; (void)color; }
+void vita2d_draw_array(SceGxmPrimitiveType mode, const vita2d_color_vertex *vertices, size_t count){ (void)mode; (void)vertices; (void)count; }
+
+void *vita2d_pool_memalign(unsigned int size, unsigned int alignment)
+{
+    void *pvMem = &acPool[uiPool];
+
+    (void)alignment; // The pool start is aligned and every block is rounded up to 16 bytes
+    uiPool += (size + 15) & ~15u;
+    return uiPool <= POOL_SIZE ? pvMem : NULL;
+}
+
+vita2d_pgf *vita2d_load_default_pgf(void)
+{
+    return &stFont;
+}
+
+int vita2d_pgf_draw_text(vita2d_pgf *font, int x, int y, unsigned int color, float scale, const char *text)
+{
+    (void)font; (void)x; (void)y; (void)color; (void)scale;
+    if (uiNrOfTexts < MAX_TEXTS){
+        snprintf(aacTexts[uiNrOfTexts++], TEXT_LENGTH, "%s", text);
+    }
+    return 0;
+}
+
+// The game frees the font right after its last frame, the overlay of that frame is the report
+void vita2d_free_pgf(vita2d_pgf *font)
+{
+    unsigned long long ulTime = sceKernelGetProcessTimeWide() - ulStartUs;
+
+    (void)font;
+    printf("frames\t\t%u in %.1f s, %.1f us per frame\n", uiFrame, ulTime / 1e6, (double)ulTime / uiFrame);
+    for (int k=0; k<uiNrOfTexts; k++){
+        printf("  %s\n", aacTexts[k]);
+    }
+}
+
+int sceRtcGetCurrentClockLocalTime(SceDateTime *time)
+{
+    memset(time, 0, sizeof(SceDateTime));
+    return 0;
+}
+
+unsigned int sceRtcGetMicrosecond(const SceDateTime *time)
+{
+    (void)time;
+    return 12345; // Same dice in every run
+}
+
+int sceDisplayWaitVblankStart(void)
+{
+    return 0;
+}
+
+// Memory blocks come from the heap, the only block the game asks for is the static vertex list
+SceUID sceKernelAllocMemBlock(const char *name, SceKernelMemBlockType type, int size, void *optp)
+{
+    (void)name; (void)type; (void)optp;
+    if (pvBlock != NULL){
+        return -1;
+    }
+    pvBlock = aligned_alloc(4096, size);
+    return pvBlock != NULL ? 1 : -1;
+}
+
+int sceKernelFreeMemBlock(SceUID uid)
+{
+    (void)uid;
+    free(pvBlock);
+    pvBlock = NULL;
+    return 0;
+}
+
+int sceKernelGetMemBlockBase(SceUID uid, void **basep)
+{
+    (void)uid;
+    *basep = pvBlock;
+    return 0;
+}
+
+int sceGxmMapMemory(void *base, size_t size, SceGxmMemoryAttribFlags attr)
+{
+    (void)base; (void)size; (void)attr;
+    return 0;
+}
+
+int sceCtrlSetSamplingMode(int mode)
+{
+    (void)mode;
+    return 0;
+}
+
+int sceCtrlPeekBufferPositive(int port, SceCtrlData *data, int count)
+{
+    (void)port; (void)count;
+    memset(data, 0, sizeof(SceCtrlData));
+    data->lx = data->ly = data->rx = data->ry = 128;
+    data->buttons |= uiFrame == 2 ? SCE_CTRL_START : 0;
+    data->buttons |= uiFrame % 20 == 5 ? SCE_CTRL_CIRCLE : 0;
+    data->buttons |= uiFrame >= uiFrames ? SCE_CTRL_SELECT : 0;
+    return 1;
+}
+
+int sceTouchSetSamplingState(int port, int state)
+{
+    (void)port; (void)state;
+    return 0;
+}
+
+int sceTouchPeek(int port, SceTouchData *data, int count)
+{
+    (void)count;
+    memset(data, 0, sizeof(SceTouchData));
+    if (port == SCE_TOUCH_PORT_FRONT && uiFrame % 2 == 0){ // Somewhere on the board, touch coordinates are twice the screen ones
+        data->reportNum = 1;
+        data->report[0].x = ((WIDTH - HEIGHT)/2 + Rand() % HEIGHT) * 2;
+        data->report[0].y = (Rand() % HEIGHT) * 2;
+    }
+    return 0;
+}
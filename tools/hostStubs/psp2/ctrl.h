@@ -0,0 +1,41 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef PSP2_CTRL_H
+#define PSP2_CTRL_H
+
+enum
+{
+    SCE_CTRL_SELECT = 0x00000001,
+    SCE_CTRL_START = 0x00000008,
+    SCE_CTRL_UP = 0x00000010,
+    SCE_CTRL_RIGHT = 0x00000020,
+    SCE_CTRL_DOWN = 0x00000040,
+    SCE_CTRL_LEFT = 0x00000080,
+    SCE_CTRL_LTRIGGER = 0x00000100,
+    SCE_CTRL_RTRIGGER = 0x00000200,
+    SCE_CTRL_TRIANGLE = 0x00001000,
+    SCE_CTRL_CIRCLE = 0x00002000,
+    SCE_CTRL_CROSS = 0x00004000,
+    SCE_CTRL_SQUARE = 0x00008000
+};
+
+enum
+{
+    SCE_CTRL_MODE_DIGITAL,
+    SCE_CTRL_MODE_ANALOG,
+    SCE_CTRL_MODE_ANALOG_WIDE
+};
+
+typedef struct SceCtrlData
+{
+    unsigned long long timeStamp;
+    unsigned int buttons;
+    unsigned char lx;
+    unsigned char ly;
+    unsigned char rx;
+    unsigned char ry;
+} SceCtrlData;
+
+int sceCtrlSetSamplingMode(int mode);
+int sceCtrlPeekBufferPositive(int port, SceCtrlData *data, int count);
+
+#endif
@@ -0,0 +1,23 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef PSP2_GXM_H
+#define PSP2_GXM_H
+
+#include <stddef.h>
+
+typedef enum SceGxmPrimitiveType
+{
+    SCE_GXM_PRIMITIVE_TRIANGLES,
+    SCE_GXM_PRIMITIVE_TRIANGLE_STRIP,
+    SCE_GXM_PRIMITIVE_TRIANGLE_FAN
+} SceGxmPrimitiveType;
+
+typedef enum SceGxmMemoryAttribFlags
+{
+    SCE_GXM_MEMORY_ATTRIB_READ = 1,
+    SCE_GXM_MEMORY_ATTRIB_WRITE = 2,
+    SCE_GXM_MEMORY_ATTRIB_RW = 3
+} SceGxmMemoryAttribFlags;
+
+int sceGxmMapMemory(void *base, size_t size, SceGxmMemoryAttribFlags attr);
+
+#endif
@@ -0,0 +1,7 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef PSP2_KERNEL_PROCESSMGR_H
+#define PSP2_KERNEL_PROCESSMGR_H
+
+unsigned long long sceKernelGetProcessTimeWide(void);
+
+#endif
@@ -0,0 +1,17 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef PSP2_KERNEL_SYSMEM_H
+#define PSP2_KERNEL_SYSMEM_H
+
+typedef int SceUID;
+
+typedef enum SceKernelMemBlockType
+{
+    SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE = 0x0C208060,
+    SCE_KERNEL_MEMBLOCK_TYPE_USER_RW = 0x0C20D060
+} SceKernelMemBlockType;
+
+SceUID sceKernelAllocMemBlock(const char *name, SceKernelMemBlockType type, int size, void *optp);
+int sceKernelFreeMemBlock(SceUID uid);
+int sceKernelGetMemBlockBase(SceUID uid, void **basep);
+
+#endif
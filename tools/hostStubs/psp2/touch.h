@@ -0,0 +1,38 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef PSP2_TOUCH_H
+#define PSP2_TOUCH_H
+
+#define SCE_TOUCH_MAX_REPORT 8
+
+enum
+{
+    SCE_TOUCH_PORT_FRONT,
+    SCE_TOUCH_PORT_BACK
+};
+
+enum
+{
+    SCE_TOUCH_SAMPLING_STATE_STOP,
+    SCE_TOUCH_SAMPLING_STATE_START
+};
+
+typedef struct SceTouchReport
+{
+    unsigned char id;
+    unsigned char force;
+    unsigned short x;
+    unsigned short y;
+} SceTouchReport;
+
+typedef struct SceTouchData
+{
+    unsigned long long timeStamp;
+    unsigned int status;
+    unsigned int reportNum;
+    SceTouchReport report[SCE_TOUCH_MAX_REPORT];
+} SceTouchData;
+
+int sceTouchSetSamplingState(int port, int state);
+int sceTouchPeek(int port, SceTouchData *data, int count);
+
+#endif
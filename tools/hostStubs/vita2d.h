@@ -0,0 +1,34 @@
+// Host stand-in for the vita2d header, only what the game uses, implemented by tools/hostGame.c
+#ifndef VITA2D_H
+#define VITA2D_H
+
+#include <stddef.h>
+#include <psp2/gxm.h>
+
+#define RGBA8(r, g, b, a) ((((a)&0xFF)<<24) | (((b)&0xFF)<<16) | (((g)&0xFF)<<8) | (((r)&0xFF)<<0))
+
+typedef struct vita2d_color_vertex
+{
+    float x;
+    float y;
+    float z;
+    unsigned int color;
+} vita2d_color_vertex;
+
+typedef struct vita2d_pgf vita2d_pgf;
+
+int vita2d_init(void);
+void vita2d_start_drawing(void);
+void vita2d_end_drawing(void);
+void vita2d_clear_screen(void);
+void vita2d_swap_buffers(void);
+void vita2d_wait_rendering_done(void);
+void vita2d_draw_rectangle(float x, float y, float w, float h, unsigned int color);
+void vita2d_draw_fill_circle(float x, float y, float radius, unsigned int color);
+void vita2d_draw_array(SceGxmPrimitiveType mode, const vita2d_color_vertex *vertices, size_t count);
+void *vita2d_pool_memalign(unsigned int size, unsigned int alignment);
+vita2d_pgf *vita2d_load_default_pgf(void);
+int vita2d_pgf_draw_text(vita2d_pgf *font, int x, int y, unsigned int color, float scale, const char *text);
+void vita2d_free_pgf(vita2d_pgf *font);
+
+#endif
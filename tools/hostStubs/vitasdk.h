@@ -0,0 +1,20 @@
+// Host stand-in for the Vita SDK header, only what the game uses, implemented by tools/hostGame.c
+#ifndef VITASDK_H
+#define VITASDK_H
+
+typedef struct SceDateTime
+{
+    unsigned short year;
+    unsigned short month;
+    unsigned short day;
+    unsigned short hour;
+    unsigned short minute;
+    unsigned short second;
+    unsigned int microsecond;
+} SceDateTime;
+
+int sceRtcGetCurrentClockLocalTime(SceDateTime *time);
+unsigned int sceRtcGetMicrosecond(const SceDateTime *time);
+int sceDisplayWaitVblankStart(void);
+
+#endif
@@ -0,0 +1,387 @@
+// Plays lockstep games between peers on one machine and measures bandwidth, latency and desync handling
+// Build: gcc -O2 -Isrc -o lockstepTest tools/lockstepTest.c src/lockstep.c src/gameRules.c src/raceTable.c src/memTrack.c -lm
+// Usage: ./lockstepTest [loop|udp] [peers] [games] [desync turn] [drop %], without arguments a fixed set of loop cases runs
+// loop runs all peers in this process, udp runs every peer in its own process on 127.0.0.1
+// From the desync turn on peer 1 gets a wrong board or dice seed before its next own turn every other game, 0 turns it off
+// The loop transport loses the given share of the messages to every peer and also hands peer 1 two messages too short for their type
+// Every peer has to end on the board of the same game played on one machine
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "lockstep.h"
+
+#define UDP_PORT 47400 // Peer n listens on UDP_PORT+n
+#define LOOP_QUEUE 64 // Messages per peer in the loopback transport
+#define TIMEOUT_US 10000000 // A game that takes longer has stalled
+#define LOOP_WAIT_US 2000 // Loop peers run in one thread, a turn missing this long got lost
+#define MAX_TURNS 4000
+
+typedef struct tStLoopQueue
+{
+    unsigned char aauiMsg[LOOP_QUEUE][LOCK_MAX_MSG];
+    unsigned int auiSize[LOOP_QUEUE];
+    unsigned int uiHead;
+    unsigned int uiTail;
+} tStLoopQueue;
+
+typedef struct tStLoopLink
+{
+    unsigned short uiPeer;
+    unsigned short uiNrOfPeers;
+    tStLoopQueue *astQueues;
+} tStLoopLink;
+
+typedef struct tStUdpLink
+{
+    int iSocket;
+    unsigned short uiPeer;
+    unsigned short uiNrOfPeers;
+} tStUdpLink;
+
+typedef struct tStResult
+{
+    tStLockStats stStats;
+    unsigned long long ulHash;
+    unsigned int uiTurns;
+    bool xFinished;
+    unsigned long long ulInjectTime;
+    unsigned int uiInjectTurn;
+} tStResult;
+
+static int iDropRate = 0; // Percent of the loop messages which are lost
+
+static unsigned long long GetTimeUs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1000000ULL + stTime.tv_nsec / 1000;
+}
+
+static void LoopPut(tStLoopQueue *pstQueue, const unsigned char *pcData, unsigned int uiSize)
+{
+    if (pstQueue->uiHead - pstQueue->uiTail < LOOP_QUEUE){ // A full queue drops like a network would
+        memcpy(pstQueue->aauiMsg[pstQueue->uiHead % LOOP_QUEUE], pcData, uiSize);
+        pstQueue->auiSize[pstQueue->uiHead % LOOP_QUEUE] = uiSize;
+        pstQueue->uiHead++;
+    }
+}
+
+static unsigned int LoopSend(void *pvCtx, const unsigned char *pcData, unsigned int uiSize)
+{
+    tStLoopLink *pstLink = pvCtx;
+    unsigned int uiBytes = 0;
+
+    // One copy per peer like unicast datagrams, a lost copy was still sent
+    for (int p=0; p<pstLink->uiNrOfPeers; p++){
+        if (p != pstLink->uiPeer){
+            if (rand() % 100 >= iDropRate){
+                LoopPut(&pstLink->astQueues[p], pcData, uiSize);
+            }
+            uiBytes += uiSize;
+        }
+    }
+
+    return uiBytes;
+}
+
+static unsigned int LoopReceive(void *pvCtx, unsigned char *pcData, unsigned int uiSize)
+{
+    tStLoopLink *pstLink = pvCtx;
+    tStLoopQueue *pstQueue = &pstLink->astQueues[pstLink->uiPeer];
+
+    if (pstQueue->uiHead == pstQueue->uiTail){
+        return 0;
+    }
+    unsigned int uiLength = pstQueue->auiSize[pstQueue->uiTail % LOOP_QUEUE];
+    memcpy(pcData, pstQueue->aauiMsg[pstQueue->uiTail % LOOP_QUEUE], uiLength < uiSize ? uiLength : uiSize);
+    pstQueue->uiTail++;
+    return uiLength;
+}
+
+static unsigned int UdpSend(void *pvCtx, const unsigned char *pcData, unsigned int uiSize)
+{
+    tStUdpLink *pstLink = pvCtx;
+    struct sockaddr_in stAddr = {0};
+    unsigned int uiBytes = 0;
+
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int p=0; p<pstLink->uiNrOfPeers; p++){
+        if (p != pstLink->uiPeer){
+            stAddr.sin_port = htons(UDP_PORT + p);
+            ssize_t iSent = sendto(pstLink->iSocket, pcData, uiSize, 0, (struct sockaddr *)&stAddr, sizeof(stAddr));
+            uiBytes += iSent > 0 ? iSent : 0;
+        }
+    }
+
+    return uiBytes;
+}
+
+static unsigned int UdpReceive(void *pvCtx, unsigned char *pcData, unsigned int uiSize)
+{
+    tStUdpLink *pstLink = pvCtx;
+    ssize_t iLength = recv(pstLink->iSocket, pcData, uiSize, 0);
+
+    return iLength > 0 ? iLength : 0;
+}
+
+static int OpenUdp(unsigned short uiPeer)
+{
+    struct sockaddr_in stAddr = {0};
+    int iSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    int iYes = 1;
+
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    stAddr.sin_port = htons(UDP_PORT + uiPeer);
+    setsockopt(iSocket, SOL_SOCKET, SO_REUSEADDR, &iYes, sizeof(iYes));
+    if (iSocket < 0 || bind(iSocket, (struct sockaddr *)&stAddr, sizeof(stAddr)) != 0){
+        return -1;
+    }
+    fcntl(iSocket, F_SETFL, O_NONBLOCK);
+
+    return iSocket;
+}
+
+static unsigned char GetSeats(int iPeer, int iPeers)
+{
+    unsigned char uiSeats = 0;
+
+    for (int p=1; p<5; p++){
+        uiSeats |= (p-1) % iPeers == iPeer ? 1 << p : 0;
+    }
+
+    return uiSeats;
+}
+
+static void Corrupt(tStGame *stGame, int iGame)
+{
+    if (iGame % 2 == 0){ // Put a stray pawn on the first free field of the track
+        for (int k=0; k<FIELD_SIZE*FIELD_SIZE; k++){
+            if (stGame->Field[k/FIELD_SIZE][k%FIELD_SIZE].eData == Empty){
+                stGame->Field[k/FIELD_SIZE][k%FIELD_SIZE].eData = PlayerFour;
+                break;
+            }
+        }
+    } else{
+        stGame->uiSeed ^= 0x5A5A;
+    }
+}
+
+// The same game without any network, the peers have to end exactly here
+static void PlayClean(tStGame *stGame, unsigned int uiSeed, tStResult *pstResult)
+{
+    BoardInitializer(stGame);
+    stGame->eTurn = PlayerOne;
+    SeedDice(stGame, uiSeed);
+    pstResult->uiTurns = 0;
+    pstResult->xFinished = false;
+
+    while (!pstResult->xFinished && pstResult->uiTurns < MAX_TURNS){
+        pstResult->xFinished = PlayTurn(stGame, PickPawnComputer);
+        pstResult->uiTurns++;
+        if (!pstResult->xFinished){
+            SwitchPlayer(stGame);
+        }
+    }
+    pstResult->ulHash = HashBoard(stGame);
+}
+
+// A turn without its throws and a state without its board, both have to be dropped unread
+static void PutShortMessages(tStLoopQueue *pstQueue)
+{
+    unsigned char acMsg[LOCK_MAX_MSG] = {0};
+
+    acMsg[0] = LockTurn;
+    acMsg[LOCK_HEADER+8] = 255;
+    LoopPut(pstQueue, acMsg, LOCK_HEADER+2);
+    acMsg[0] = LockState;
+    acMsg[LOCK_HEADER+5] = LOCK_ALL;
+    LoopPut(pstQueue, acMsg, LOCK_HEADER+8);
+}
+
+static void StepUntilDone(tStLockPeer *astPeers, tStResult *astResults, int iFirst, int iCount, int iGame, unsigned int uiDesyncTurn)
+{
+    unsigned long long ulStart = GetTimeUs();
+    bool xDone = false;
+
+    // Keep stepping finished peers as well, they may still have to answer a resync request
+    while (!xDone && GetTimeUs() - ulStart < TIMEOUT_US){
+        xDone = true;
+        for (int p=iFirst; p<iFirst+iCount; p++){
+            xDone &= LockstepStep(&astPeers[p], PickPawnComputer);
+            // Right before a turn of its own, so the peer that went apart is the one that sends the disputed turn
+            if (p == 1 && uiDesyncTurn > 0 && astResults[p].ulInjectTime == 0 && astPeers[p].uiTurn >= uiDesyncTurn && (astPeers[p].uiSeats & (1 << (astPeers[p].stGame->eTurn/POFF)))){
+                Corrupt(astPeers[p].stGame, iGame);
+                astResults[p].ulInjectTime = GetTimeUs();
+                astResults[p].uiInjectTurn = astPeers[p].uiTurn;
+            }
+        }
+        if (iCount == 1){ // Processes share the cores, give the peers a chance to answer
+            sched_yield();
+        }
+    }
+    for (int p=iFirst; p<iFirst+iCount; p++){
+        unsigned long long ulUntil = GetTimeUs() + 20000;
+        while (GetTimeUs() < ulUntil && iCount == 1){ // A lone process answers late resync requests for a moment
+            LockstepStep(&astPeers[p], PickPawnComputer);
+        }
+        astResults[p].stStats = astPeers[p].stStats;
+        astResults[p].ulHash = HashBoard(astPeers[p].stGame);
+        astResults[p].uiTurns = astPeers[p].uiTurn;
+        astResults[p].xFinished = astPeers[p].xFinished;
+    }
+}
+
+// Returns true when every peer of every game ended on the board of the clean game
+static bool RunCase(bool xUdp, int iPeers, int iGames, unsigned int uiDesyncTurn, int iDrop)
+{
+    static tStGame stCleanGame;
+    static tStLoopQueue astQueues[LOCK_MAX_PEERS];
+    tStLoopLink astLoop[LOCK_MAX_PEERS];
+    tStUdpLink astUdp[LOCK_MAX_PEERS];
+    tStGame astGames[LOCK_MAX_PEERS];
+    tStLockPeer astPeers[LOCK_MAX_PEERS];
+    tStResult astResults[LOCK_MAX_PEERS];
+    unsigned long long ulBytes = 0, ulTurns = 0, ulApplyUs = 0, ulMaxApplyUs = 0, ulRemoteTurns = 0;
+    unsigned long long ulDetectUs = 0, ulResyncUs = 0, ulDetectTurns = 0;
+    unsigned int uiInjected = 0, uiDetected = 0, uiMismatches = 0, uiStalled = 0, uiRejected = 0, uiTimeouts = 0;
+
+    iDropRate = iDrop;
+    srand(1);
+
+    iPeers = iPeers < 2 ? 2 : (iPeers > LOCK_MAX_PEERS ? LOCK_MAX_PEERS : iPeers);
+    for (int p=0; p<iPeers; p++){
+        astGames[p].uiFieldHeight = FIELD_SIZE;
+        astGames[p].uiFieldWidth = FIELD_SIZE;
+        BoardConstructor(&astGames[p]);
+    }
+    stCleanGame.uiFieldHeight = FIELD_SIZE;
+    stCleanGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stCleanGame);
+    RaceTableBuild();
+
+    for (int g=0; g<iGames; g++){
+        memset(astResults, 0, sizeof(astResults));
+
+        if (!xUdp){
+            memset(astQueues, 0, sizeof(astQueues));
+            for (int p=0; p<iPeers; p++){
+                astLoop[p] = (tStLoopLink){p, iPeers, astQueues};
+                LockstepInit(&astPeers[p], &astGames[p], p, GetSeats(p, iPeers), (tStTransport){&astLoop[p], LoopSend, LoopReceive}, GetTimeUs);
+                astPeers[p].ulTimeoutUs = LOOP_WAIT_US;
+            }
+            PutShortMessages(&astQueues[1]);
+            LockstepStart(&astPeers[0], g+1);
+            StepUntilDone(astPeers, astResults, 0, iPeers, g, uiDesyncTurn);
+        } else{
+            // All sockets are bound before the first peer sends anything
+            int aiPipe[LOCK_MAX_PEERS][2];
+            for (int p=0; p<iPeers; p++){
+                astUdp[p] = (tStUdpLink){OpenUdp(p), p, iPeers};
+                if (astUdp[p].iSocket < 0 || pipe(aiPipe[p]) != 0){
+                    fprintf(stderr, "cannot open UDP port %d\n", UDP_PORT + p);
+                    return false;
+                }
+            }
+            for (int p=0; p<iPeers; p++){
+                if (fork() == 0){
+                    LockstepInit(&astPeers[p], &astGames[p], p, GetSeats(p, iPeers), (tStTransport){&astUdp[p], UdpSend, UdpReceive}, GetTimeUs);
+                    if (p == 0){
+                        usleep(1000); // Let the other processes start polling
+                        LockstepStart(&astPeers[0], g+1);
+                    }
+                    StepUntilDone(astPeers, astResults, p, 1, g, uiDesyncTurn);
+                    write(aiPipe[p][1], &astResults[p], sizeof(tStResult));
+                    _exit(0);
+                }
+            }
+            for (int p=0; p<iPeers; p++){
+                if (read(aiPipe[p][0], &astResults[p], sizeof(tStResult)) != sizeof(tStResult)){
+                    astResults[p].xFinished = false;
+                }
+                close(aiPipe[p][0]);
+                close(aiPipe[p][1]);
+                close(astUdp[p].iSocket);
+            }
+            while (wait(NULL) > 0);
+        }
+
+        // All peers have to end on the board of the clean game
+        tStResult stClean;
+        unsigned long long ulFirstDetect = 0;
+        unsigned long long ulLastResync = 0;
+        unsigned int uiDetectTurn = 0;
+        PlayClean(&stCleanGame, g+1, &stClean);
+        for (int p=0; p<iPeers; p++){
+            uiMismatches += astResults[p].ulHash != stClean.ulHash || astResults[p].uiTurns != stClean.uiTurns;
+            uiStalled += !astResults[p].xFinished;
+            uiRejected += astResults[p].stStats.uiRejected;
+            uiTimeouts += astResults[p].stStats.uiTimeouts;
+            ulLastResync = astResults[p].stStats.ulResyncTime > ulLastResync ? astResults[p].stStats.ulResyncTime : ulLastResync;
+            ulBytes += astResults[p].stStats.uiBytesSent;
+            ulApplyUs += astResults[p].stStats.ulApplyUs;
+            ulRemoteTurns += astResults[p].stStats.uiRemoteTurns;
+            ulMaxApplyUs = astResults[p].stStats.ulMaxApplyUs > ulMaxApplyUs ? astResults[p].stStats.ulMaxApplyUs : ulMaxApplyUs;
+            if (astResults[p].stStats.uiDesyncs > 0 && (ulFirstDetect == 0 || astResults[p].stStats.ulDesyncTime < ulFirstDetect)){
+                ulFirstDetect = astResults[p].stStats.ulDesyncTime;
+                uiDetectTurn = astResults[p].stStats.uiDesyncTurn;
+            }
+        }
+        ulTurns += astResults[0].uiTurns;
+        if (astResults[1].ulInjectTime > 0){
+            uiInjected++;
+            if (ulFirstDetect >= astResults[1].ulInjectTime){
+                uiDetected++;
+                ulDetectUs += ulFirstDetect - astResults[1].ulInjectTime;
+                ulResyncUs += ulLastResync >= ulFirstDetect ? ulLastResync - ulFirstDetect : 0; // Until the last peer loaded a state
+                ulDetectTurns += uiDetectTurn - astResults[1].uiInjectTurn;
+            }
+        }
+    }
+
+    printf("transport\t\t%s, %d peers, %d games, %llu turns, %d%% lost\n", xUdp ? "udp" : "loop", iPeers, iGames, ulTurns, xUdp ? 0 : iDropRate);
+    printf("bandwidth\t\t%.1f bytes sent per turn by all peers\n", (double)ulBytes / ulTurns);
+    printf("apply latency\t\tmean %.1f us, worst %llu us\n", ulRemoteTurns ? (double)ulApplyUs / ulRemoteTurns : 0, ulMaxApplyUs);
+    printf("desyncs\t\t\t%u injected, %u detected", uiInjected, uiDetected);
+    if (uiDetected > 0){
+        printf(" after %.2f turns and %.1f us, resynced %.1f us later", (double)ulDetectTurns / uiDetected, (double)ulDetectUs / uiDetected, (double)ulResyncUs / uiDetected);
+    }
+    printf("\ntimeouts\t\t%u, %u short messages rejected\n", uiTimeouts, uiRejected);
+    printf("final state mismatches\t%u against the clean game, stalled peers %u\n", uiMismatches, uiStalled);
+
+    for (int p=0; p<iPeers; p++){
+        BoardDestructor(&astGames[p]);
+    }
+    BoardDestructor(&stCleanGame);
+    return uiMismatches == 0 && uiStalled == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // Loss and desyncs together, 2 peers with early desyncs used to replay a turn on a board that already went apart
+    static const int aaiCases[][4] = {{2, 100, 40, 0}, {4, 100, 40, 0}, {2, 50, 5, 10}, {2, 100, 1, 30}, {4, 100, 40, 20}};
+    int iFailed = 0;
+
+    if (argc > 1){
+        return !RunCase(strcmp(argv[1], "udp") == 0, argc > 2 ? atoi(argv[2]) : 2, argc > 3 ? atoi(argv[3]) : 100, argc > 4 ? atoi(argv[4]) : 40, argc > 5 ? atoi(argv[5]) : 0);
+    }
+
+    for (size_t c=0; c<sizeof(aaiCases)/sizeof(aaiCases[0]); c++){
+        bool xOk = RunCase(false, aaiCases[c][0], aaiCases[c][1], aaiCases[c][2], aaiCases[c][3]);
+        printf("%s\n\n", xOk ? "ok" : "FAIL");
+        iFailed += !xOk;
+    }
+    printf("%d of %d cases failed\n", iFailed, (int)(sizeof(aaiCases)/sizeof(aaiCases[0])));
+    return iFailed > 0;
+}
@@ -0,0 +1,120 @@
+// Plays headless games and checks that no memory is allocated once the game is set up
+// Build: gcc -O2 -Isrc -o memReport tools/memReport.c src/gameRules.c src/raceTable.c src/evaluator.c src/history.c src/memTrack.c src/winMeter.c src/strategy.c -lm -ldl
+// Usage: ./memReport [games], exits with 1 when the heap was used during play
+// Needs glibc, the allocator of the C library is replaced to see every call and not only MemAlloc
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gameRules.h"
+#include "evaluator.h"
+#include "history.h"
+#include "memTrack.h"
+#include "winMeter.h"
+#include "strategy.h"
+
+#define MAX_TURNS 4000
+#define WINMETER_BUDGET_US 20 // Playouts per turn, the game spends this per frame
+
+extern void *__libc_malloc(size_t uiSize);
+extern void *__libc_calloc(size_t uiCount, size_t uiSize);
+extern void *__libc_realloc(void *pMem, size_t uiSize);
+extern void __libc_free(void *pMem);
+
+static bool xCounting = false;
+static unsigned int uiRawAllocs = 0; // Calls into the C library allocator while counting, frees included
+
+// Every allocation of the process lands here, raw malloc calls and those inside the C library as well
+void *malloc(size_t uiSize)
+{
+    uiRawAllocs += xCounting;
+    return __libc_malloc(uiSize);
+}
+
+void *calloc(size_t uiCount, size_t uiSize)
+{
+    uiRawAllocs += xCounting;
+    return __libc_calloc(uiCount, uiSize);
+}
+
+void *realloc(void *pMem, size_t uiSize)
+{
+    uiRawAllocs += xCounting;
+    return __libc_realloc(pMem, uiSize);
+}
+
+void free(void *pMem)
+{
+    uiRawAllocs += xCounting && pMem != NULL;
+    __libc_free(pMem);
+}
+
+static unsigned long long GetTimeUs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1000000ULL + stTime.tv_nsec / 1000;
+}
+
+int main(int argc, char *argv[])
+{
+    int iGames = argc > 1 ? atoi(argv[1]) : 1000;
+    tPickPawn apfPick[5] = {NULL, PickPawnEvaluator, PickPawnStrategy, PickPawnComputer, PickPawnStrategy};
+    static const char *apcTags[MemTags] = {"board", "playout", "race", "evaluator", "strategy", "render"};
+    static tStHistory stHistory;
+    static tStWinMeter stMeter;
+    tStGame stGame;
+
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    BoardInitializer(&stGame);
+    RaceTableBuild();
+    EvaluatorInit(&stGame);
+    SeedDice(&stGame, 1);
+    StrategyInit(GetTimeUs);
+    StrategySetSeat(PlayerTwo, StrategyFind("greedy"));
+    WinMeterInit(&stMeter, &stGame);
+    MemLock(true);
+    xCounting = true;
+
+    // Same work as the frame loop: restart, play turns, keep the history and take turns back now and then
+    for (int g=0; g<iGames; g++){
+        BoardInitializer(&stGame);
+        stGame.eTurn = PlayerOne;
+        HistoryReset(&stHistory);
+
+        for (int t=0; t<MAX_TURNS; t++){
+            MemNextFrame();
+            if (stGame.eTurn == PlayerOne){
+                HistoryPush(&stHistory, &stGame);
+                if (t % 50 == 1 && HistoryUndo(&stHistory, &stGame)){
+                    HistoryRedo(&stHistory, &stGame);
+                }
+            }
+            if (PlayTurn(&stGame, apfPick[stGame.eTurn/POFF])){
+                break;
+            }
+            SwitchPlayer(&stGame);
+            WinMeterRestart(&stMeter, &stGame, GetTimeUs);
+            WinMeterUpdate(&stMeter, WINMETER_BUDGET_US, GetTimeUs);
+        }
+    }
+    xCounting = false;
+    MemLock(false);
+
+    tStMemStats stStats = MemGetStats();
+    tStRaceStats stRace = RaceTableGetStats();
+    printf("games played\t\t%d\n", iGames);
+    printf("allocations during play\t%u MemAlloc, %u malloc/calloc/realloc/free\n", stStats.uiLockedAllocs, uiRawAllocs);
+    printf("%-12s %10s %8s %10s %10s\n", "subsystem", "heap", "blocks", "peak", "static");
+    for (int t=0; t<MemTags; t++){
+        printf("%-12s %10zu %8u %10zu %10zu\n", apcTags[t], stStats.astTag[t].uiBytes, stStats.astTag[t].uiAllocs, stStats.astTag[t].uiPeakBytes, stStats.astTag[t].uiStaticBytes);
+    }
+    printf("per game instance\t%zu bytes (tStGame + board heap + tStHistory)\n", sizeof(tStGame) + stStats.astTag[MemBoard].uiBytes + sizeof(tStHistory));
+    printf("shared tables\t\t%u bytes (race table)\n", stRace.uiTableBytes);
+
+    BoardDestructor(&stGame);
+    return stStats.uiLockedAllocs == 0 && uiRawAllocs == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Checks the race table on positions with a known answer
+// Build: gcc -O2 -Isrc -o raceTableTest tools/raceTableTest.c src/gameRules.c src/raceTable.c src/memTrack.c -lm
+// Usage: ./raceTableTest, exits with 1 when a check fails
+
+#include <stdio.h>
+
+#include "gameRules.h"
+
+static int iFailures = 0;
+
+static void Check(bool xOk, const char *pcWhat)
+{
+    printf("%s\t%s\n", xOk ? "ok" : "FAIL", pcWhat);
+    iFailures += !xOk;
+}
+
+// Empties the start area of the player, takes the home slots in uiHomeMask and puts one pawn on the track uiDist fields before the home entry
+static tStPosition PlaceRacer(tStGame *stGame, tEnumPlayer ePlayer, unsigned char uiHomeMask, unsigned short uiDist)
+{
+    tStPosition stPawn = {-1, -1, 0};
+    tEnumPlayer eTurn = stGame->eTurn;
+
+    for (tStPosition stPos=CheckStartPos(stGame, ePlayer, false); stPos.uiColIndex <= stGame->uiFieldWidth; stPos=CheckStartPos(stGame, ePlayer, false)){
+        stGame->Field[stPos.uiRowIndex][stPos.uiColIndex].eData = Empty;
+    }
+    for (int k=1; k<5; k++){
+        if (uiHomeMask & (1 << (k-1))){
+            tStPosition stSlot = GetHomeSlot(stGame, ePlayer, k);
+            stGame->Field[stSlot.uiRowIndex][stSlot.uiColIndex].eData = ePlayer;
+        }
+    }
+
+    // GetDistToHomePos walks towards the home entry of the player in turn
+    stGame->eTurn = ePlayer;
+    for (int i=0; i<stGame->uiFieldHeight && stPawn.uiColIndex > stGame->uiFieldWidth; i++){
+        for (int j=0; j<stGame->uiFieldWidth && stPawn.uiColIndex > stGame->uiFieldWidth; j++){
+            if (stGame->Field[i][j].eData == Empty){
+                stGame->Field[i][j].eData = ePlayer;
+                tStPosition stPos = ChoosePawn(stGame, i, j);
+                if (stPos.uiColIndex <= stGame->uiFieldWidth && GetDistToHomePos(stGame, stPos) == uiDist){
+                    stPawn = stPos;
+                } else{
+                    stGame->Field[i][j].eData = Empty;
+                }
+            }
+        }
+    }
+    stGame->eTurn = eTurn;
+
+    return stPawn;
+}
+
+int main()
+{
+    tStGame stGame;
+    tStRacePos stMover = {1, {2, 0}, 0x7};
+    tStRacePos stRival = {1, {5, 0}, 0x7};
+    tStRacePos stNext;
+
+    RaceTableBuild();
+
+    // A 6 from two fields before the home entry takes the last pawn into slot 4
+    Check(RaceMove(&stMover, 0, 6, &stNext) && stNext.uiNrOfPawns == 0 && stNext.uiHomeMask == 0xF, "6 finishes the last pawn");
+    Check(RaceWinChance(&stNext, &stRival) == 1, "finished mover wins for sure");
+    Check(RaceExpectedTurns(&stNext) == 0, "finished mover needs no turns");
+
+    float rWin = RaceWinChance(&stMover, &stRival);
+    float rLose = RaceWinChance(&stRival, &stMover);
+    Check(rWin > 0 && rWin < 1 && rLose > 0 && rLose < 1, "race win chances lie between 0 and 1");
+    Check(rWin > rLose, "pawn closer to home has the better chance");
+
+    // Same race on the board, the computer has to take the finishing move
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    BoardInitializer(&stGame);
+    stGame.eTurn = PlayerOne;
+    tStPosition stPawn = PlaceRacer(&stGame, PlayerOne, 0x7, 2);
+    PlaceRacer(&stGame, PlayerTwo, 0x7, 5);
+
+    tStPosition stPick = PickPawnRace(&stGame, 6);
+    Check(stPawn.uiColIndex <= stGame.uiFieldWidth && stPick.uiRowIndex == stPawn.uiRowIndex && stPick.uiColIndex == stPawn.uiColIndex, "board pick takes the finishing move");
+    Check(ApplyMove(&stGame, stPick, 6) && CheckWinner(&stGame), "finishing move wins the game");
+
+    BoardDestructor(&stGame);
+    tStRaceStats stStats = RaceTableGetStats();
+    printf("race table\t%u states, %u bytes, built in %lu us\n", stStats.uiStates, stStats.uiTableBytes, stStats.ulBuildTimeUs);
+    printf("%d failures\n", iFailures);
+    return iFailures > 0;
+}
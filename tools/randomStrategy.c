@@ -0,0 +1,25 @@
+// Example strategy plug-in, plays a random legal move
+// Build: gcc -O2 -shared -fPIC -Isrc -o randomStrategy.so tools/randomStrategy.c
+// Usage: ./strategyBench 1000 ./randomStrategy.so
+
+#include "strategy.h"
+
+static void EvaluateRandom(const tStSnapshot *astPositions, unsigned int uiCount, tEnumPlayer ePlayer, int *aiScores)
+{
+    static unsigned int uiState = 2463534242u;
+
+    (void)astPositions; (void)ePlayer;
+    for (unsigned int n=0; n<uiCount; n++){
+        uiState ^= uiState << 13;
+        uiState ^= uiState >> 17;
+        uiState ^= uiState << 5;
+        aiScores[n] = uiState >> 1;
+    }
+}
+
+static const tStStrategy stRandom = {STRATEGY_ABI_VERSION, "random", EvaluateRandom, NULL};
+
+const tStStrategy *GetStrategy()
+{
+    return &stRandom;
+}
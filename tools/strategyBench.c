@@ -0,0 +1,139 @@
+// Plays headless games between strategies and reports wins, latency and throughput per strategy
+// Build: gcc -O2 -Isrc -o strategyBench tools/strategyBench.c src/strategy.c src/gameRules.c src/raceTable.c src/evaluator.c src/memTrack.c -lm -ldl
+// Usage: ./strategyBench [games] [seat 2] [seat 3] [seat 4], a seat is a built-in name or the path of a plug-in (.so)
+// PlayerOne always plays greedy as reference. Before every turn the picks for all dice values are taken in one batch
+// like the move hints of the game do, they are reported apart and checked against the single pick of the throw.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "strategy.h"
+#include "evaluator.h"
+
+#define MAX_TURNS 4000
+
+static tStSnapshot stHintPos; // Position of the last StrategyPickAll
+static tStPosition astHintPicks[7];
+static unsigned int uiChecked = 0;
+static unsigned int uiMismatches = 0;
+static bool axPlugin[STRATEGY_MAX]; // Plug-ins may pick at random and are not checked
+static tStStrategyStats astPickStats[STRATEGY_MAX];
+static tStStrategyStats astHintStats[STRATEGY_MAX];
+
+static unsigned long long GetTimeUs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1000000ULL + stTime.tv_nsec / 1000;
+}
+
+// Compares the single pick with the batch of all dice values while the position has not changed
+static tStPosition PickPawnChecked(tStGame *stGame, unsigned short uiDice)
+{
+    int iStrategy = StrategyGetSeat(stGame->eTurn);
+    unsigned long long ulStart = GetTimeUs();
+    tStPosition stPos = PickPawnStrategy(stGame, uiDice);
+    unsigned long long ulTime = GetTimeUs() - ulStart;
+    tStSnapshot stNow;
+
+    astPickStats[iStrategy].ulMaxPickUs = ulTime > astPickStats[iStrategy].ulMaxPickUs ? ulTime : astPickStats[iStrategy].ulMaxPickUs;
+    SaveSnapshot(stGame, &stNow);
+    if (!axPlugin[iStrategy] && stNow.eTurn == stHintPos.eTurn && memcmp(stNow.auiData, stHintPos.auiData, sizeof(stNow.auiData)) == 0){
+        uiChecked++;
+        uiMismatches += stPos.uiRowIndex != astHintPicks[uiDice].uiRowIndex || stPos.uiColIndex != astHintPicks[uiDice].uiColIndex;
+    }
+    return stPos;
+}
+
+// Adds the counters between two readings, the longest call is measured by the caller
+static void AddStats(tStStrategyStats *pstSum, tStStrategyStats stAfter, tStStrategyStats stBefore)
+{
+    pstSum->uiPicks += stAfter.uiPicks - stBefore.uiPicks;
+    pstSum->uiPositions += stAfter.uiPositions - stBefore.uiPositions;
+    pstSum->uiBatches += stAfter.uiBatches - stBefore.uiBatches;
+    pstSum->ulPickUs += stAfter.ulPickUs - stBefore.ulPickUs;
+    pstSum->ulEvaluateUs += stAfter.ulEvaluateUs - stBefore.ulEvaluateUs;
+}
+
+static void PrintStats(const char *pcTitle, const tStStrategyStats *astStats)
+{
+    printf("\n%s\tpicks\tmean us\tmax us\tbatches\tpositions/batch\tpositions/s\n", pcTitle);
+    for (int k=0; k<StrategyCount(); k++){
+        if (astStats[k].uiPicks == 0){
+            continue;
+        }
+        printf("%s\t%u\t%.2f\t%llu\t%u\t%.2f\t\t", StrategyName(k), astStats[k].uiPicks, (double)astStats[k].ulPickUs / astStats[k].uiPicks, astStats[k].ulMaxPickUs, astStats[k].uiBatches, astStats[k].uiBatches > 0 ? (double)astStats[k].uiPositions / astStats[k].uiBatches : 0);
+        if (astStats[k].ulEvaluateUs > 0){
+            printf("%.0f\n", astStats[k].uiPositions * 1e6 / astStats[k].ulEvaluateUs);
+        } else{
+            printf("-\n");
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int iGames = argc > 1 ? atoi(argv[1]) : 1000;
+    unsigned int auiWins[5] = {0};
+    tStGame stGame;
+
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    RaceTableBuild();
+    EvaluatorInit(&stGame);
+    StrategyInit(GetTimeUs);
+    SeedDice(&stGame, 1);
+
+    StrategySetSeat(PlayerOne, StrategyFind("greedy"));
+    for (int p=2; p<5; p++){
+        int iStrategy = StrategyFind("evaluator");
+        if (argc > p){
+            iStrategy = strstr(argv[p], ".so") != NULL ? StrategyLoad(argv[p]) : StrategyFind(argv[p]);
+            if (iStrategy < 0){
+                fprintf(stderr, "cannot use strategy %s\n", argv[p]);
+                return 1;
+            }
+            axPlugin[iStrategy] = strstr(argv[p], ".so") != NULL;
+        }
+        StrategySetSeat(p*POFF, iStrategy);
+    }
+
+    for (int g=0; g<iGames; g++){
+        BoardInitializer(&stGame);
+        stGame.eTurn = PlayerOne;
+        for (int t=0; t<MAX_TURNS; t++){
+            int iStrategy = StrategyGetSeat(stGame.eTurn);
+            tStStrategyStats stBefore = StrategyGetStats(iStrategy);
+            unsigned long long ulStart = GetTimeUs();
+            StrategyPickAll(&stGame, astHintPicks);
+            unsigned long long ulTime = GetTimeUs() - ulStart;
+            astHintStats[iStrategy].ulMaxPickUs = ulTime > astHintStats[iStrategy].ulMaxPickUs ? ulTime : astHintStats[iStrategy].ulMaxPickUs;
+            SaveSnapshot(&stGame, &stHintPos);
+            tStStrategyStats stHint = StrategyGetStats(iStrategy);
+            AddStats(&astHintStats[iStrategy], stHint, stBefore);
+
+            bool xWon = PlayTurn(&stGame, PickPawnChecked);
+            AddStats(&astPickStats[iStrategy], StrategyGetStats(iStrategy), stHint);
+            if (xWon){
+                auiWins[stGame.eTurn/POFF]++;
+                break;
+            }
+            SwitchPlayer(&stGame);
+        }
+    }
+
+    printf("seat\tstrategy\twins\n");
+    for (int p=1; p<5; p++){
+        printf("%d\t%s\t\t%.1f%%\n", p, StrategyName(StrategyGetSeat(p*POFF)), 100.0 * auiWins[p] / iGames);
+    }
+
+    PrintStats("pick", astPickStats);
+    PrintStats("all dice", astHintStats);
+    printf("\n%u of %u picks match the batch of all dice values\n", uiChecked - uiMismatches, uiChecked);
+
+    BoardDestructor(&stGame);
+    return uiMismatches > 0;
+}
@@ -0,0 +1,195 @@
+// Self-play trainer for the position evaluator in src/evaluator.c
+// Build on a Linux host: gcc -O2 -Isrc -o tdTrainer tools/tdTrainer.c src/gameRules.c src/raceTable.c src/evaluator.c src/memTrack.c -lm
+// Usage: ./tdTrainer [games] [output header]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "gameRules.h"
+#include "evaluator.h"
+
+#define ALPHA 0.01f // Learning rate
+#define EPSILON 0.1f // Chance of an exploring move during self-play
+#define EVAL_INTERVAL 2000 // Training games between two measurements against PickPawnComputer
+#define EVAL_GAMES 1000 // Spread evenly over the four seats
+#define MAX_TURNS 4000 // Give up on games that do not finish
+
+static float arWeights[EVAL_FEATURES];
+static float rEpsilon = EPSILON;
+
+static float GetValue(const short *aiFeatures)
+{
+    float rSum = 0;
+
+    for (int k=0; k<EVAL_FEATURES; k++){
+        rSum += arWeights[k] * aiFeatures[k];
+    }
+
+    return 1.0f / (1.0f + expf(-rSum / 256.0f));
+}
+
+static void Learn(const short *aiFeatures, float rTarget)
+{
+    float rValue = GetValue(aiFeatures);
+    float rDelta = ALPHA * (rTarget - rValue) * rValue * (1 - rValue);
+
+    for (int k=0; k<EVAL_FEATURES; k++){
+        arWeights[k] += rDelta * aiFeatures[k] / 256.0f;
+    }
+}
+
+static tStPosition PickPawnTrainer(tStGame *stGame, unsigned short uiDice)
+{
+    tStPosition astPawns[4];
+    unsigned short n = 0;
+    short aiFeatures[EVAL_FEATURES];
+    float rBest = -1;
+    tStPosition stBestPos = {-1, -1, 0};
+
+    for (int i=0; i<stGame->uiFieldHeight; i++){
+        for (int j=0; j<stGame->uiFieldWidth; j++){
+            tStPosition stPawn = ChoosePawn(stGame, i, j);
+            if (stPawn.uiColIndex <= stGame->uiFieldWidth && IsMoveLegal(stGame, stPawn, uiDice)){
+                astPawns[n++] = stPawn;
+            }
+        }
+    }
+
+    if (n == 0){
+        return PickPawnComputer(stGame, uiDice);
+    } else if ((float)rand() / RAND_MAX < rEpsilon){
+        return astPawns[rand() % n];
+    }
+
+    for (int k=0; k<n; k++){
+        tStMove stMove;
+        MakeMove(stGame, astPawns[k], uiDice, &stMove);
+        GetFeatures(stGame, stGame->eTurn, aiFeatures);
+        UnmakeMove(stGame, &stMove);
+        float rValue = GetValue(aiFeatures);
+        if (rValue > rBest){
+            rBest = rValue;
+            stBestPos = astPawns[k];
+        }
+    }
+
+    return stBestPos;
+}
+
+static tEnumPlayer PlayGame(tStGame *stGame, tPickPawn *apfPick, bool xLearn)
+{
+    short aaiLast[5][EVAL_FEATURES];
+    bool axLast[5] = {false};
+    short aiFeatures[EVAL_FEATURES];
+
+    BoardInitializer(stGame);
+    stGame->eTurn = PlayerOne;
+
+    for (int t=0; t<MAX_TURNS; t++){
+        short p = stGame->eTurn/POFF;
+        bool xWon = PlayTurn(stGame, apfPick[p]);
+
+        if (xLearn){ // TD(0) on the positions a player leaves behind at the end of the turn
+            GetFeatures(stGame, stGame->eTurn, aiFeatures);
+            if (axLast[p]){
+                Learn(aaiLast[p], GetValue(aiFeatures));
+            }
+            for (int k=0; k<EVAL_FEATURES; k++){
+                aaiLast[p][k] = aiFeatures[k];
+            }
+            axLast[p] = true;
+        }
+
+        if (xWon){
+            for (int q=1; xLearn && q<5; q++){
+                if (axLast[q]){
+                    Learn(aaiLast[q], q == p ? 1 : 0);
+                }
+            }
+            return stGame->eTurn;
+        }
+        SwitchPlayer(stGame);
+    }
+
+    return NoPosition;
+}
+
+int main(int argc, char *argv[])
+{
+    int iGames = argc > 1 ? atoi(argv[1]) : 20000;
+    const char *sOutput = argc > 2 ? argv[2] : "src/evalWeights.h";
+    tPickPawn apfSelfPlay[5] = {NULL, PickPawnTrainer, PickPawnTrainer, PickPawnTrainer, PickPawnTrainer};
+    tPickPawn apfMatch[5];
+    tStGame stGame;
+
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    BoardInitializer(&stGame);
+    EvaluatorInit(&stGame);
+    RaceTableBuild();
+    srand(1);
+    SeedDice(&stGame, 1);
+
+    // The trainer takes every seat in turn, seat 1 moves first and wins more often
+    printf("games\tgames/sec\twin rate vs PickPawnComputer\tseat 1\tseat 2\tseat 3\tseat 4\tspread\n");
+    clock_t tStart = clock();
+
+    for (int g=1; g<=iGames; g++){
+        PlayGame(&stGame, apfSelfPlay, true);
+
+        if (g % EVAL_INTERVAL == 0 || g == iGames){
+            double rSeconds = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+            int aiWins[5] = {0};
+            int aiGames[5] = {0};
+            float rLow = 1;
+            float rHigh = 0;
+
+            rEpsilon = 0;
+            for (int m=0; m<EVAL_GAMES; m++){
+                short s = m%4 + 1;
+                for (int p=1; p<5; p++){
+                    apfMatch[p] = p == s ? PickPawnTrainer : PickPawnComputer;
+                }
+                aiWins[s] += PlayGame(&stGame, apfMatch, false) == (tEnumPlayer)(s*POFF);
+                aiGames[s]++;
+            }
+            rEpsilon = EPSILON;
+
+            printf("%d\t%.0f\t\t%.3f\t\t\t", g, g / rSeconds, (float)(aiWins[1] + aiWins[2] + aiWins[3] + aiWins[4]) / EVAL_GAMES);
+            for (int p=1; p<5; p++){
+                float rRate = (float)aiWins[p] / aiGames[p];
+                rLow = rRate < rLow ? rRate : rLow;
+                rHigh = rRate > rHigh ? rRate : rHigh;
+                printf("%.3f\t", rRate);
+            }
+            printf("%.3f\n", rHigh - rLow);
+        }
+    }
+
+    // Quantise to signed bytes, the scale does not change which move scores best
+    float rMax = 0;
+    for (int k=0; k<EVAL_FEATURES; k++){
+        rMax = fabsf(arWeights[k]) > rMax ? fabsf(arWeights[k]) : rMax;
+    }
+
+    FILE *pFile = fopen(sOutput, "w");
+    if (pFile == NULL){
+        perror(sOutput);
+        return 1;
+    }
+
+    fprintf(pFile, "#ifndef EVALWEIGHTS_H\n#define EVALWEIGHTS_H\n\n");
+    fprintf(pFile, "// Generated by tools/tdTrainer.c after %d self-play games, do not edit by hand\n", iGames);
+    fprintf(pFile, "static const signed char aiEvalWeights[EVAL_FEATURES] = {");
+    for (int k=0; k<EVAL_FEATURES; k++){
+        fprintf(pFile, "%s%d", k == 0 ? "" : ", ", (int)lroundf(arWeights[k] * 127 / (rMax > 0 ? rMax : 1)));
+    }
+    fprintf(pFile, "};\n\n#endif\n");
+    fclose(pFile);
+
+    BoardDestructor(&stGame);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Runs the win meter on self-play positions with the per frame budget of the game and reports its speed
+// Build: gcc -O2 -Isrc -o winMeterReport tools/winMeterReport.c src/winMeter.c src/gameRules.c src/raceTable.c src/memTrack.c -lm
+// Usage: ./winMeterReport [positions] [budget us]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "winMeter.h"
+
+#define MAX_FRAMES 600 // Ten seconds at 60 frames per second, positions that take longer count as not settled
+#define FRAME_US 16667
+
+static unsigned long long ulFrameOffset = 0; // The game spends the rest of each frame on other work
+
+static unsigned long long GetTimeUs()
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return stTime.tv_sec * 1000000ULL + stTime.tv_nsec / 1000 + ulFrameOffset;
+}
+
+int main(int argc, char *argv[])
+{
+    int iPositions = argc > 1 ? atoi(argv[1]) : 200;
+    unsigned long long ulBudgetUs = argc > 2 ? strtoull(argv[2], NULL, 10) : 2000;
+    static tStWinMeter stMeter;
+    tStGame stGame;
+    unsigned long ulFrames = 0;
+    unsigned long long ulConvergeUs = 0;
+    int iSettled = 0;
+
+    stGame.uiFieldHeight = FIELD_SIZE;
+    stGame.uiFieldWidth = FIELD_SIZE;
+    BoardConstructor(&stGame);
+    BoardInitializer(&stGame);
+    stGame.eTurn = PlayerOne;
+    SeedDice(&stGame, 1);
+    RaceTableBuild();
+    WinMeterInit(&stMeter, &stGame);
+
+    for (int n=0; n<iPositions; n++){
+        for (int t=0; t<4; t++){ // Positions a few turns apart like the meter sees them during a game
+            if (PlayTurn(&stGame, PickPawnComputer)){
+                BoardInitializer(&stGame);
+                stGame.eTurn = PlayerOne;
+            } else{
+                SwitchPlayer(&stGame);
+            }
+        }
+
+        WinMeterRestart(&stMeter, &stGame, GetTimeUs);
+        for (int f=0; f<MAX_FRAMES && stMeter.ulConvergeUs == 0; f++){
+            WinMeterUpdate(&stMeter, ulBudgetUs, GetTimeUs);
+            ulFrameOffset += FRAME_US - ulBudgetUs;
+            ulFrames++;
+        }
+        iSettled += stMeter.ulConvergeUs > 0;
+        ulConvergeUs += stMeter.ulConvergeUs;
+    }
+
+    printf("positions\t\t%d, %llu us per frame\n", iPositions, ulBudgetUs);
+    printf("playouts\t\t%.0f/s of playout time\n", WinMeterPlayoutsPerSec(&stMeter));
+    printf("settled\t\t\t%d of %d within %d frames\n", iSettled, iPositions, MAX_FRAMES);
+    printf("time to settle\t\t%.0f ms, %.1f frames on average over the settled positions\n", iSettled > 0 ? ulConvergeUs / 1000.0 / iSettled : 0, (double)ulFrames / iPositions);
+
+    BoardDestructor(&stGame);
+    return 0;
+}